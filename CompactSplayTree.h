@@ -0,0 +1,425 @@
+/*
+CompactSplayTree.h
+
+Copyright (C) 2026 SplayTree contributors
+Built on SplayTree.h, Copyright (C) 2015-2019 Kingston Chan. This file is not
+part of the original source.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+SplayTree contributors
+
+*/
+
+#ifndef CompactSplayTREE_H
+#define CompactSplayTREE_H
+
+#include "SplayTree.h"
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////Compact splay tree/////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A Splay tree whose nodes live in one vector and point to their sons by 32
+// bit indices. A node is its ID, its record (none for NULLT) and two indices,
+// 12 bytes for SplayTree<int> against 40 for a Node plus its heap block. No
+// parent, height or count is kept, so there are no iterators, ranks or
+// aggregates; the splay is the same top-down one. The slots of deleted nodes
+// are chained on a free list through their left index and used again first.
+// Indices do not change when the vector grows, so the tree is one block that
+// is copied or moved as a whole; record pointers do, and are only good until
+// the next insert.
+template<class T1, class T2 = NULLT, class Compare = PtrCmp<T1>, class Alloc = std::allocator<T1> >
+class CompactSplayTree : private Compare {
+
+private :
+	static const uint32_t NIL = 0xFFFFFFFFu;	// no node
+
+	class CNode : private RcdHolder<T2> {	// an empty record takes no space
+	public :
+		T1 ID;
+		uint32_t Lft, Rgt;
+		CNode() : Lft(NIL), Rgt(NIL) {}
+		template<class... Args>
+		CNode(const T1 &id, Args&&... args) : RcdHolder<T2>(EmplaceRcd(), std::forward<Args>(args)...), ID(id),
+			Lft(NIL), Rgt(NIL) {}
+		T2 *getRcd() const { return this->rcdPtr(); }
+	};
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<CNode> NodeAlloc;
+
+	struct KeyProbe {	// towards the node with ID "id"
+		const CompactSplayTree<T1, T2, Compare, Alloc> *tree;
+		const T1 &id;
+		int operator()(const CNode &node) const { return tree->compare(id, node.ID); }
+	};
+	struct MaxProbe {	// towards the right most node
+		int operator()(const CNode &) const { return 1; }
+	};
+
+	std::vector<CNode, NodeAlloc> nodes;
+	uint32_t root;
+	uint32_t freeHead;	// the first free slot, chained through Lft
+	int size;
+
+	int compare(const T1 &a, const T1 &b) const { return Compare::operator()(a, b); }
+	template<class... Args>
+	uint32_t newSlot(const T1 &id, Args&&... args);
+	void freeSlot(uint32_t idx);
+	template<class Probe>
+	uint32_t splayBy(uint32_t t, const Probe &probe, int *res = NULL);
+public :
+	CompactSplayTree(const Compare &compare = Compare(), const Alloc &a = Alloc())
+		: Compare(compare), nodes(NodeAlloc(a)), root(NIL), freeHead(NIL), size(0) {}
+
+	bool Insert(const T1 &id) { try_emplace(id); return true; }
+	template<class... Args>
+	std::pair<T2*, bool> try_emplace(const T1 &id, Args&&... args);
+	bool Delete(const T1 &id);
+	bool empty();
+	void reserve(size_t n) { nodes.reserve(n); }
+
+	int getSize() const { return size; }
+	size_t getBytes() const { return nodes.capacity() * sizeof(CNode); }
+	T2 *find(const T1 &id);
+	T2 *peek(const T1 &id) const;
+	T1 rootID() const { return nodes[root].ID; }
+	template<class Func>
+	void forEach(Func fn) const;
+	void swap(CompactSplayTree<T1, T2, Compare, Alloc> &b);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: newSlot
+// DESCRIPTION: To build a node in the first free slot, or at the end of the
+//				vector, which grows by doubling.
+//   ARGUMENTS: const T1 &id - the ID of the node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: nodes, freeHead
+//     RETURNS: uint32_t - the index of the node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+template<class... Args>
+uint32_t CompactSplayTree<T1, T2, Compare, Alloc>::newSlot(const T1 &id, Args&&... args) {
+	uint32_t idx = freeHead;
+	if (idx != NIL) {
+		freeHead = nodes[idx].Lft;
+		nodes[idx] = CNode(id, std::forward<Args>(args)...);
+		return idx;
+	}
+	if (nodes.size() >= NIL)
+		throw SplayERR("CompactSplayTree: more than 2^32 - 1 nodes");
+	nodes.emplace_back(id, std::forward<Args>(args)...);
+	return (uint32_t)(nodes.size() - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: freeSlot
+// DESCRIPTION: To put a slot on the free list. The node is reset first, so
+//				it holds nothing (a string ID, say) while it waits.
+//   ARGUMENTS: uint32_t idx - the index of the slot
+// USES GLOBAL: none
+// MODIFIES GL: nodes, freeHead
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+void CompactSplayTree<T1, T2, Compare, Alloc>::freeSlot(uint32_t idx) {
+	nodes[idx] = CNode();
+	nodes[idx].Lft = freeHead;
+	freeHead = idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: splayBy
+// DESCRIPTION: The top-down splay of SplayTree on indices. The nodes passed
+//				on the left and on the right are hung on two trees through a
+//				pointer to the free son field at the tail of each, and a
+//				probe result is kept for the next step when it is known.
+//   ARGUMENTS: uint32_t t - the root of the subtree
+//				const Probe &probe - tells which way to go from a node
+//				int *res - gets the probe result at the new root
+// USES GLOBAL: none
+// MODIFIES GL: nodes
+//     RETURNS: uint32_t - the new root of the subtree
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+template<class Probe>
+uint32_t CompactSplayTree<T1, T2, Compare, Alloc>::splayBy(uint32_t t, const Probe &probe, int *res) {
+	CNode *N = nodes.data();	// nothing is allocated during a splay
+	uint32_t L = NIL, R = NIL;	// the roots of the left and the right trees
+	uint32_t *lTail = &L, *rTail = &R;
+	uint32_t son;
+	int c = probe(N[t]), c2;
+	while (c != 0) {
+		if (c < 0) {
+			son = N[t].Lft;
+			if (son == NIL)
+				break;
+			c2 = probe(N[son]);
+			if (c2 < 0 && N[son].Lft != NIL) {	// zig-zig: rotate right, then link right
+				N[t].Lft = N[son].Rgt;
+				N[son].Rgt = t;
+				*rTail = son;
+				rTail = &N[son].Lft;
+				t = N[son].Lft;
+				c = probe(N[t]);
+			}
+			else {	// zig or zig-zag: link right
+				*rTail = t;
+				rTail = &N[t].Lft;
+				t = son;
+				c = c2;
+			}
+		}
+		else {
+			son = N[t].Rgt;
+			if (son == NIL)
+				break;
+			c2 = probe(N[son]);
+			if (c2 > 0 && N[son].Rgt != NIL) {	// zig-zig: rotate left, then link left
+				N[t].Rgt = N[son].Lft;
+				N[son].Lft = t;
+				*lTail = son;
+				lTail = &N[son].Rgt;
+				t = N[son].Rgt;
+				c = probe(N[t]);
+			}
+			else {	// zig or zig-zag: link left
+				*lTail = t;
+				lTail = &N[t].Rgt;
+				t = son;
+				c = c2;
+			}
+		}
+	}
+
+	// assemble
+	*lTail = N[t].Lft;
+	*rTail = N[t].Rgt;
+	N[t].Lft = L;
+	N[t].Rgt = R;
+	if (res != NULL)
+		*res = c;
+	return t;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: try_emplace
+// DESCRIPTION: To insert a node with ID "id" whose record is built from
+//				"args". Nothing is built if the ID is already there.
+//   ARGUMENTS: const T1 &id - the ID of the node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: nodes, root, size
+//     RETURNS: std::pair<T2*, bool> - the record of the node with that ID, and
+//				whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+template<class... Args>
+std::pair<T2*, bool> CompactSplayTree<T1, T2, Compare, Alloc>::try_emplace(const T1 &id, Args&&... args) {
+	uint32_t idx;
+	int res = 0;
+	if (root != NIL) {
+		root = splayBy(root, KeyProbe{ this, id }, &res);
+		if (res == 0)
+			return std::make_pair(nodes[root].getRcd(), false);
+	}
+	idx = newSlot(id, std::forward<Args>(args)...);	// may move the vector: indices only from here
+
+	// the new node becomes the root and takes the old one to one side
+	if (root != NIL) {
+		if (res < 0) {
+			nodes[idx].Lft = nodes[root].Lft;
+			nodes[root].Lft = NIL;
+			nodes[idx].Rgt = root;
+		}
+		else {
+			nodes[idx].Rgt = nodes[root].Rgt;
+			nodes[root].Rgt = NIL;
+			nodes[idx].Lft = root;
+		}
+	}
+	root = idx;
+	size++;
+	return std::make_pair(nodes[idx].getRcd(), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete the node with ID "id". Its slot goes on the free
+//				list and the vector never shrinks.
+//   ARGUMENTS: const T1 &id - the ID of the node that is to be deleted
+// USES GLOBAL: none
+// MODIFIES GL: nodes, root, size
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+bool CompactSplayTree<T1, T2, Compare, Alloc>::Delete(const T1 &id) {
+	uint32_t lft, rgt, old;
+	int res;
+	MaxProbe toMax;
+	if (root == NIL)
+		return true;
+	root = splayBy(root, KeyProbe{ this, id }, &res);
+	if (res != 0)
+		return true;
+	old = root;
+	lft = nodes[old].Lft;
+	rgt = nodes[old].Rgt;
+	if (lft == NIL)
+		root = rgt;
+	else {
+		root = splayBy(lft, toMax);	// no compare needed
+		nodes[root].Rgt = rgt;
+	}
+	freeSlot(old);
+	size--;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: empty
+// DESCRIPTION: To delete all the nodes and give the vector back.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: nodes, root, freeHead, size
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+bool CompactSplayTree<T1, T2, Compare, Alloc>::empty() {
+	std::vector<CNode, NodeAlloc>(nodes.get_allocator()).swap(nodes);
+	root = freeHead = NIL;
+	size = 0;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To splay the node with ID "id" to the root.
+//   ARGUMENTS: const T1 &id - the ID
+// USES GLOBAL: none
+// MODIFIES GL: nodes, root
+//     RETURNS: T2* - the record, or NULL if "id" is not there. It is good
+//				until the next insert
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+T2 *CompactSplayTree<T1, T2, Compare, Alloc>::find(const T1 &id) {
+	int res;
+	if (root == NIL)
+		return NULL;
+	root = splayBy(root, KeyProbe{ this, id }, &res);
+	return res == 0 ? nodes[root].getRcd() : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: peek
+// DESCRIPTION: To find "id" by a plain binary search that does not splay.
+//   ARGUMENTS: const T1 &id - the ID
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2* - the record, or NULL if "id" is not there
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+T2 *CompactSplayTree<T1, T2, Compare, Alloc>::peek(const T1 &id) const {
+	uint32_t t = root;
+	int c;
+	while (t != NIL) {
+		c = compare(id, nodes[t].ID);
+		if (c == 0)
+			return nodes[t].getRcd();
+		t = c < 0 ? nodes[t].Lft : nodes[t].Rgt;
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: forEach
+// DESCRIPTION: To call "fn" on every node in order. The tree is walked with a
+//				stack of indices, so it is left as it is.
+//   ARGUMENTS: Func fn - called as fn(const T1 &id, T2 &rcd)
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+template<class Func>
+void CompactSplayTree<T1, T2, Compare, Alloc>::forEach(Func fn) const {
+	std::vector<uint32_t> stk;
+	uint32_t t = root;
+	while (t != NIL || !stk.empty()) {
+		while (t != NIL) {
+			stk.push_back(t);
+			t = nodes[t].Lft;
+		}
+		t = stk.back();
+		stk.pop_back();
+		fn(nodes[t].ID, *nodes[t].getRcd());
+		t = nodes[t].Rgt;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: swap
+// DESCRIPTION: To swap two trees in O(1).
+//   ARGUMENTS: CompactSplayTree<T1, T2, Compare, Alloc> &b - the other tree
+// USES GLOBAL: none
+// MODIFIES GL: nodes, root, freeHead, size, Compare
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc>
+void CompactSplayTree<T1, T2, Compare, Alloc>::swap(CompactSplayTree<T1, T2, Compare, Alloc> &b) {
+	using std::swap;
+	swap(static_cast<Compare&>(*this), static_cast<Compare&>(b));
+	nodes.swap(b.nodes);
+	swap(root, b.root);
+	swap(freeHead, b.freeHead);
+	swap(size, b.size);
+}
+
+#endif
@@ -0,0 +1,381 @@
+/*
+ConcurrentSplayTree.h
+
+Copyright (C) 2026 SplayTree contributors
+Built on SplayTree.h, Copyright (C) 2015-2019 Kingston Chan. This file is not
+part of the original source.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+SplayTree contributors
+
+*/
+
+#ifndef ConcurrentSplayTREE_H
+#define ConcurrentSplayTREE_H
+
+#include "SplayTree.h"
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// how lookups through find() change the shape of the tree
+enum AdaptMode {
+	AdaptNever,		// never: find() is the same as peek()
+	AdaptRandom,	// about one hit in "period" is splayed at once
+	AdaptBatched	// hits are logged and splayed "period" at a time
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////Concurrent splay tree////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A Splay tree behind a reader/writer lock. Lookups search without splaying
+// under the shared lock, so readers run in parallel; the splays that keep hot
+// IDs near the root are only done now and then, under the exclusive lock.
+template<class T1, class T2 = NULLT, class Compare = PtrCmp<T1>, class Alloc = std::allocator<T1>,
+	class Augment = NoAugment>
+class ConcurrentSplayTree {
+
+private :
+	enum { NSTRIPE = 16 };	// number of access logs
+	struct alignas(64) LogStripe {	// a cache line each, so the logs are not shared
+		std::mutex mtx;
+		std::vector<T1> keys;
+	};
+
+	SplayTree<T1, T2, Compare, Alloc, Augment> tree;
+	mutable std::shared_mutex mtx;
+	const AdaptMode mode;
+	const unsigned period;
+	LogStripe logs[NSTRIPE];
+
+	static unsigned threadSlot();
+	static unsigned threadRand();
+	void adapt(const T1 &id);
+	void replay(const std::vector<T1> &keys);
+public :
+	ConcurrentSplayTree(AdaptMode mode = AdaptRandom, unsigned period = 64, const Compare &compare = Compare(),
+		const Alloc &a = Alloc());
+	ConcurrentSplayTree(const ConcurrentSplayTree &) = delete;
+	ConcurrentSplayTree &operator=(const ConcurrentSplayTree &) = delete;
+
+	bool peek(const T1 &id, T2 *rcd = NULL) const;
+	bool find(const T1 &id, T2 *rcd = NULL);
+	bool Insert(const T1 &id);
+	template<class K, class... Args>
+	bool try_emplace(K &&id, Args&&... args);
+	bool Delete(const T1 &id);
+	void flush();
+	template<class Func>
+	void locked(Func fn);
+
+	int getSize() const;
+	int getHeight() const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ConcurrentSplayTree
+// DESCRIPTION: Constructor of ConcurrentSplayTree class.
+//   ARGUMENTS: AdaptMode mode = AdaptRandom - how find() splays
+//				unsigned period = 64 - one hit in "period" is splayed, or
+//				the size of a batch of logged hits
+//				const Compare &compare = Compare() - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes
+// USES GLOBAL: none
+// MODIFIES GL: tree, mode, period
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::ConcurrentSplayTree(AdaptMode mode, unsigned period,
+	const Compare &compare, const Alloc &a) : tree(compare, a), mode(mode), period(period == 0 ? 1 : period) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: threadSlot
+// DESCRIPTION: To get a number fixed for the calling thread, which picks the
+//				access log it writes to.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: unsigned
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+unsigned ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::threadSlot() {
+	thread_local unsigned slot = (unsigned)std::hash<std::thread::id>()(std::this_thread::get_id());
+	return slot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: threadRand
+// DESCRIPTION: A xorshift random number generator with a state per thread, so
+//				sampling the hits takes no lock.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: unsigned
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+unsigned ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::threadRand() {
+	thread_local unsigned state = threadSlot() * 2654435761u | 1;
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: adapt
+// DESCRIPTION: To let a hit on "id" change the shape of the tree, as the mode
+//				says. Must be called without holding the lock.
+//   ARGUMENTS: const T1 &id - the ID that was found
+// USES GLOBAL: none
+// MODIFIES GL: tree, logs
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::adapt(const T1 &id) {
+	std::vector<T1> batch;
+	if (mode == AdaptRandom) {
+		if (threadRand() % period == 0) {
+			std::unique_lock<std::shared_mutex> lock(mtx);
+			tree.find(id);
+		}
+	}
+	else if (mode == AdaptBatched) {
+		LogStripe &log = logs[threadSlot() % NSTRIPE];
+		{
+			std::lock_guard<std::mutex> lock(log.mtx);
+			log.keys.push_back(id);
+			if (log.keys.size() < period)
+				return;
+			batch.swap(log.keys);
+		}
+		replay(batch);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: replay
+// DESCRIPTION: To splay a batch of logged IDs, in the order they were found,
+//				under one exclusive lock. IDs deleted since are just missed.
+//   ARGUMENTS: const std::vector<T1> &keys - the batch
+// USES GLOBAL: none
+// MODIFIES GL: tree
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::replay(const std::vector<T1> &keys) {
+	if (keys.empty())
+		return;
+	std::unique_lock<std::shared_mutex> lock(mtx);
+	for (size_t i = 0; i < keys.size(); i++)
+		tree.find(keys[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: peek
+// DESCRIPTION: To look up "id" under the shared lock without splaying.
+//   ARGUMENTS: const T1 &id - the ID to search for
+//				T2 *rcd = NULL - the record is copied here if it is found
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - whether "id" is found
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::peek(const T1 &id, T2 *rcd) const {
+	std::shared_lock<std::shared_mutex> lock(mtx);
+	const T2 *found = tree.peek(id);
+	if (found == NULL)
+		return false;
+	if (rcd != NULL)
+		*rcd = *found;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: The same as peek, but a hit may splay "id" up afterwards as
+//				the adapt mode says.
+//   ARGUMENTS: const T1 &id - the ID to search for
+//				T2 *rcd = NULL - the record is copied here if it is found
+// USES GLOBAL: none
+// MODIFIES GL: tree (possible)
+//     RETURNS: bool - whether "id" is found
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::find(const T1 &id, T2 *rcd) {
+	if (!peek(id, rcd))
+		return false;
+	adapt(id);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a node with ID "id" under the exclusive lock.
+//   ARGUMENTS: const T1 &id - the ID of the new node
+// USES GLOBAL: none
+// MODIFIES GL: tree
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::Insert(const T1 &id) {
+	std::unique_lock<std::shared_mutex> lock(mtx);
+	return tree.Insert(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: try_emplace
+// DESCRIPTION: To insert a node with ID "id" and a record built from "args"
+//				under the exclusive lock. Nothing is built if "id" is there.
+//   ARGUMENTS: K &&id - the ID of the new node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: tree
+//     RETURNS: bool - whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class K, class... Args>
+bool ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::try_emplace(K &&id, Args&&... args) {
+	std::unique_lock<std::shared_mutex> lock(mtx);
+	return tree.try_emplace(std::forward<K>(id), std::forward<Args>(args)...).second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete the node with ID "id" under the exclusive lock.
+//   ARGUMENTS: const T1 &id - the ID of the node
+// USES GLOBAL: none
+// MODIFIES GL: tree
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::Delete(const T1 &id) {
+	std::unique_lock<std::shared_mutex> lock(mtx);
+	return tree.Delete(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: flush
+// DESCRIPTION: To splay every hit still waiting in the access logs.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: tree, logs
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::flush() {
+	std::vector<T1> batch;
+	for (int i = 0; i < NSTRIPE; i++) {
+		{
+			std::lock_guard<std::mutex> lock(logs[i].mtx);
+			batch.swap(logs[i].keys);
+		}
+		replay(batch);
+		batch.clear();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: locked
+// DESCRIPTION: To call fn(tree) with the underlying SplayTree under the
+//				exclusive lock, for whatever this class does not wrap.
+//   ARGUMENTS: Func fn - called as fn(SplayTree<T1, T2, Compare, Alloc, Augment> &)
+// USES GLOBAL: none
+// MODIFIES GL: tree
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class Func>
+void ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::locked(Func fn) {
+	std::unique_lock<std::shared_mutex> lock(mtx);
+	fn(tree);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getSize
+// DESCRIPTION: To get the number of nodes.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::getSize() const {
+	std::shared_lock<std::shared_mutex> lock(mtx);
+	return tree.getSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getHeight
+// DESCRIPTION: To get the height of the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int ConcurrentSplayTree<T1, T2, Compare, Alloc, Augment>::getHeight() const {
+	std::shared_lock<std::shared_mutex> lock(mtx);
+	return tree.getSize() == 0 ? 0 : tree.getHeight();
+}
+
+#endif
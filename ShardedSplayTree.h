@@ -0,0 +1,397 @@
+/*
+ShardedSplayTree.h
+
+Copyright (C) 2026 SplayTree contributors
+Built on SplayTree.h, Copyright (C) 2015-2019 Kingston Chan. This file is not
+part of the original source.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+SplayTree contributors
+
+*/
+
+#ifndef ShardedSplayTREE_H
+#define ShardedSplayTREE_H
+
+#include "SplayTree.h"
+#include <mutex>
+#include <queue>
+
+////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////Sharded splay tree/////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// The IDs are spread over several independent Splay trees, each with its own
+// lock and on its own cache lines, so threads working on different shards
+// never touch the same root. The shard of an ID is chosen by a hash of it, or
+// by ranges: with the bounds b0 < b1 < ..., shard i holds [b(i-1), b(i)).
+// Each shard gets the allocator as a copied container would, by
+// select_on_container_copy_construction, so with PoolAlloc every shard has its
+// own arena under its own lock. An allocator whose copies share state that is
+// not thread safe must give a fresh copy there too.
+template<class T1, class T2 = NULLT, class Compare = PtrCmp<T1>, class Alloc = std::allocator<T1>,
+	class Hash = std::hash<T1> >
+class ShardedSplayTree : private Compare {
+
+private :
+	typedef SplayTree<T1, T2, Compare, Alloc> Tree;
+	struct alignas(64) Shard {	// padded, so two shards never share a cache line
+		mutable std::mutex mtx;
+		Tree tree;
+	};
+
+	int nShard;
+	std::unique_ptr<Shard[]> shards;
+	std::vector<T1> bounds;	// empty in hash mode
+	Hash hash;
+
+	int compare(const T1 &a, const T1 &b) const { return Compare::operator()(a, b); }
+	int shardOf(const T1 &id) const;
+	void lockAll(std::vector<std::unique_lock<std::mutex> > &locks);
+	template<class Func>
+	int mergeFrom(std::vector<typename Tree::iterator> &its, const T1 *hi, Func fn);
+public :
+	ShardedSplayTree(int n, const Compare &compare = Compare(), const Alloc &a = Alloc(), const Hash &h = Hash());
+	ShardedSplayTree(const std::vector<T1> &bounds, const Compare &compare = Compare(), const Alloc &a = Alloc());
+	ShardedSplayTree(const ShardedSplayTree &) = delete;
+	ShardedSplayTree &operator=(const ShardedSplayTree &) = delete;
+
+	bool Insert(const T1 &id);
+	template<class K, class... Args>
+	bool try_emplace(K &&id, Args&&... args);
+	bool Delete(const T1 &id);
+	bool find(const T1 &id, T2 *rcd = NULL);
+
+	template<class Func>
+	int forEach(Func fn);
+	template<class Func>
+	int forEachInRange(const T1 &lo, const T1 &hi, Func fn);
+
+	int getSize() const;
+	int getShardCount() const { return nShard; }
+	bool isRanged() const { return !bounds.empty(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ShardedSplayTree
+// DESCRIPTION: Constructor of ShardedSplayTree class in hash mode.
+//   ARGUMENTS: int n - the number of shards
+//				const Compare &compare = Compare() - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes, copied
+//				for each shard
+//				const Hash &h = Hash() - the hash of the IDs
+// USES GLOBAL: none
+// MODIFIES GL: nShard, shards, hash, Compare
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::ShardedSplayTree(int n, const Compare &compare, const Alloc &a,
+	const Hash &h) : Compare(compare), hash(h) {
+	if (n < 1)
+		throw SplayERR("No shard");
+	nShard = n;
+	shards.reset(new Shard[n]);
+	for (int i = 0; i < n; i++)
+		shards[i].tree = Tree(compare, std::allocator_traits<Alloc>::select_on_container_copy_construction(a));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ShardedSplayTree
+// DESCRIPTION: Constructor of ShardedSplayTree class in range mode: there is
+//				one shard more than bounds.
+//   ARGUMENTS: const std::vector<T1> &bounds - the bounds, in increasing order
+//				const Compare &compare = Compare() - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes, copied
+//				for each shard
+// USES GLOBAL: none
+// MODIFIES GL: nShard, shards, bounds, Compare
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::ShardedSplayTree(const std::vector<T1> &bounds, const Compare &compare,
+	const Alloc &a) : Compare(compare), bounds(bounds) {
+	if (bounds.empty())
+		throw SplayERR("No bound");
+	for (size_t i = 1; i < bounds.size(); i++)
+		if (this->compare(bounds[i - 1], bounds[i]) >= 0)
+			throw SplayERR("Bounds not sorted");
+	nShard = (int)bounds.size() + 1;
+	shards.reset(new Shard[nShard]);
+	for (int i = 0; i < nShard; i++)
+		shards[i].tree = Tree(compare, std::allocator_traits<Alloc>::select_on_container_copy_construction(a));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: shardOf
+// DESCRIPTION: To find the shard of "id": a binary search of the bounds, or
+//				the hash mixed by a multiply so that small hashes spread too.
+//   ARGUMENTS: const T1 &id - the ID
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+int ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::shardOf(const T1 &id) const {
+	int lo = 0, hi = (int)bounds.size(), mid;
+	if (bounds.empty())
+		return (int)(((unsigned long long)hash(id) * 0x9E3779B97F4A7C15ull >> 32) % (unsigned)nShard);
+	while (lo < hi) {	// the number of bounds not greater than "id"
+		mid = (lo + hi) / 2;
+		if (compare(bounds[mid], id) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: lockAll
+// DESCRIPTION: To lock every shard, always in the same order.
+//   ARGUMENTS: std::vector<std::unique_lock<std::mutex> > &locks - the locks
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+void ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::lockAll(std::vector<std::unique_lock<std::mutex> > &locks) {
+	for (int i = 0; i < nShard; i++)
+		locks.push_back(std::unique_lock<std::mutex>(shards[i].mtx));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a node with ID "id" into its shard.
+//   ARGUMENTS: const T1 &id - the ID of the new node
+// USES GLOBAL: none
+// MODIFIES GL: shards
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+bool ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::Insert(const T1 &id) {
+	Shard &shard = shards[shardOf(id)];
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	return shard.tree.Insert(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: try_emplace
+// DESCRIPTION: To insert a node with ID "id" and a record built from "args"
+//				into its shard. Nothing is built if "id" is there.
+//   ARGUMENTS: K &&id - the ID of the new node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: shards
+//     RETURNS: bool - whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+template<class K, class... Args>
+bool ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::try_emplace(K &&id, Args&&... args) {
+	Shard &shard = shards[shardOf(id)];
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	return shard.tree.try_emplace(std::forward<K>(id), std::forward<Args>(args)...).second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete the node with ID "id" from its shard.
+//   ARGUMENTS: const T1 &id - the ID of the node
+// USES GLOBAL: none
+// MODIFIES GL: shards
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+bool ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::Delete(const T1 &id) {
+	Shard &shard = shards[shardOf(id)];
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	return shard.tree.Delete(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find "id" in its shard (which is splayed). The record is
+//				copied out, as it may change once the lock is let go.
+//   ARGUMENTS: const T1 &id - the ID to search for
+//				T2 *rcd = NULL - the record is copied here if it is found
+// USES GLOBAL: none
+// MODIFIES GL: shards
+//     RETURNS: bool - whether "id" is found
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+bool ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::find(const T1 &id, T2 *rcd) {
+	Shard &shard = shards[shardOf(id)];
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	T2 *found = shard.tree.find(id);
+	if (found == NULL)
+		return false;
+	if (rcd != NULL)
+		*rcd = *found;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: mergeFrom
+// DESCRIPTION: To call "fn" on the nodes from one iterator per shard in order
+//				of ID, by a k-way merge with a heap of the shard heads. All
+//				shards must be locked.
+//   ARGUMENTS: std::vector<typename Tree::iterator> &its - where to start
+//				const T1 *hi - stop before this ID, NULL for the end
+//				Func fn - called as fn(const Node<T1, T2> &)
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - the number of nodes visited
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+template<class Func>
+int ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::mergeFrom(std::vector<typename Tree::iterator> &its, const T1 *hi,
+	Func fn) {
+	auto later = [this, &its](int a, int b) { return compare(its[a]->getID(), its[b]->getID()) > 0; };
+	std::priority_queue<int, std::vector<int>, decltype(later)> heads(later);
+	int n = 0, i;
+	for (i = 0; i < nShard; i++)
+		if (its[i] != shards[i].tree.end())
+			heads.push(i);
+	while (!heads.empty()) {
+		i = heads.top();
+		heads.pop();
+		if (hi != NULL && compare(its[i]->getID(), *hi) >= 0)
+			continue;	// this shard is done
+		fn(*its[i]);
+		n++;
+		if (++its[i] != shards[i].tree.end())
+			heads.push(i);
+	}
+	return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: forEach
+// DESCRIPTION: To call "fn" on every node in order of ID, with every shard
+//				locked. In range mode the shards are walked one after
+//				another; in hash mode they are merged.
+//   ARGUMENTS: Func fn - called as fn(const Node<T1, T2> &)
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - the number of nodes visited
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+template<class Func>
+int ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::forEach(Func fn) {
+	std::vector<std::unique_lock<std::mutex> > locks;
+	std::vector<typename Tree::iterator> its;
+	int n = 0;
+	lockAll(locks);
+	if (isRanged()) {
+		for (int i = 0; i < nShard; i++)
+			for (typename Tree::iterator it = shards[i].tree.begin(); it != shards[i].tree.end(); ++it, n++)
+				fn(*it);
+		return n;
+	}
+	for (int i = 0; i < nShard; i++)
+		its.push_back(shards[i].tree.begin());
+	return mergeFrom(its, NULL, fn);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: forEachInRange
+// DESCRIPTION: To call "fn" on every node with ID in [lo, hi) in order. In
+//				range mode only the shards that overlap the range are locked.
+//   ARGUMENTS: const T1 &lo - the lowest ID of the range
+//				const T1 &hi - the ID just above the range
+//				Func fn - called as fn(const Node<T1, T2> &)
+// USES GLOBAL: none
+// MODIFIES GL: shards
+//     RETURNS: int - the number of nodes visited
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+template<class Func>
+int ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::forEachInRange(const T1 &lo, const T1 &hi, Func fn) {
+	std::vector<std::unique_lock<std::mutex> > locks;
+	std::vector<typename Tree::iterator> its;
+	int n = 0;
+	if (compare(lo, hi) >= 0)
+		return 0;
+	if (isRanged()) {
+		for (int i = shardOf(lo), last = shardOf(hi); i <= last; i++) {
+			std::lock_guard<std::mutex> lock(shards[i].mtx);
+			n += shards[i].tree.forEachInRange(lo, hi, fn);
+		}
+		return n;
+	}
+	lockAll(locks);
+	for (int i = 0; i < nShard; i++)
+		its.push_back(shards[i].tree.lower_bound(lo));
+	return mergeFrom(its, &hi, fn);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getSize
+// DESCRIPTION: To get the number of nodes over all the shards.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Hash>
+int ShardedSplayTree<T1, T2, Compare, Alloc, Hash>::getSize() const {
+	int n = 0;
+	for (int i = 0; i < nShard; i++) {
+		std::lock_guard<std::mutex> lock(shards[i].mtx);
+		n += shards[i].tree.getSize();
+	}
+	return n;
+}
+
+#endif
@@ -0,0 +1,353 @@
+/*
+SplayCache.h
+
+Copyright (C) 2026 SplayTree contributors
+Built on SplayTree.h, Copyright (C) 2015-2019 Kingston Chan. This file is not
+part of the original source.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+SplayTree contributors
+
+*/
+
+#ifndef SplayCACHE_H
+#define SplayCACHE_H
+
+#include "SplayTree.h"
+
+// the record of an entry in a SplayCache
+template<class V>
+class CacheEntry {
+public :
+	V value;
+	unsigned long long stamp;	// when the entry was last touched
+	size_t bytes;	// what the entry is charged against the byte capacity
+	CacheEntry() : value(), stamp(0), bytes(0) {}
+};
+
+// keeps the least stamp of every subtree, so the least recently used entry
+// can be found from the root
+template<class K, class V>
+class StampMin {
+public :
+	typedef unsigned long long value_type;
+	static value_type identity() { return ~0ull; }
+	static value_type lift(const K &, const CacheEntry<V> &e) { return e.stamp; }
+	static value_type combine(const value_type &a, const value_type &b) { return a < b ? a : b; }
+};
+
+enum CacheEvict {
+	EvictLRU,	// the least recently touched entry
+	EvictDeep	// the deepest entry, which no recent splay has come near
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////Splay cache/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A cache kept in a single Splay tree. A hit splays the entry to the root and
+// stamps it; the least stamp of every subtree is kept as the aggregate, so the
+// least recently used entry is splayed up and cut off in O(log n) amortized,
+// with no list beside the tree. With EvictDeep the stamps are not kept up to
+// date and the deepest node (found by the subtree heights) goes instead.
+template<class K, class V, class Compare = PtrCmp<K>, class Alloc = std::allocator<K> >
+class SplayCache : private SplayTree<K, CacheEntry<V>, Compare, Alloc, StampMin<K, V> > {
+
+private :
+	typedef SplayTree<K, CacheEntry<V>, Compare, Alloc, StampMin<K, V> > Base;
+	typedef Node<K, CacheEntry<V>, StampMin<K, V> > CacheNode;
+
+	struct StampProbe {	// towards the node with the stamp "least"
+		unsigned long long least;
+		int operator()(const CacheNode *node) const {
+			if (node->getRcd()->stamp == least)
+				return 0;
+			if (node->getLft() != NULL && node->getLft()->getAgg() == least)
+				return -1;
+			return 1;
+		}
+	};
+	struct DeepProbe {	// towards the deepest node
+		int operator()(const CacheNode *node) const {
+			int lh = node->getLft() == NULL ? -1 : node->getLft()->getHeight();
+			int rh = node->getRgt() == NULL ? -1 : node->getRgt()->getHeight();
+			if (lh < 0 && rh < 0)
+				return 0;
+			return lh >= rh ? -1 : 1;
+		}
+	};
+
+	CacheEvict evict;
+	size_t maxEntries, maxBytes;	// 0 for no limit
+	size_t nBytes;
+	unsigned long long clock;
+	unsigned long long hits, misses, evictions;
+
+	void touch(CacheEntry<V> *e);
+	bool full() const;
+	bool evictOne();
+public :
+	SplayCache(size_t entries, size_t bytes = 0, CacheEvict how = EvictLRU, const Compare &compare = Compare(),
+		const Alloc &a = Alloc());
+
+	V *get(const K &key);
+	const V *peek(const K &key) const;
+	bool put(const K &key, const V &value, size_t bytes = 0);
+	bool erase(const K &key);
+	void clear();
+	bool setCapacity(size_t entries, size_t bytes = 0);
+
+	using Base::getSize;
+	size_t getBytes() const { return nBytes; }
+	unsigned long long getHitCount() const { return hits; }
+	unsigned long long getMissCount() const { return misses; }
+	unsigned long long getEvictCount() const { return evictions; }
+	void resetCounts() { hits = misses = evictions = 0; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: SplayCache
+// DESCRIPTION: The constructor of a cache of at most "entries" entries and
+//				"bytes" bytes; 0 leaves that side unbounded.
+//   ARGUMENTS: size_t entries - the entry capacity
+//				size_t bytes - the byte capacity
+//				CacheEvict how - which entry goes when the cache is full
+//				const Compare &compare - the compare function of the keys
+//				const Alloc &a - the allocator of the nodes
+// USES GLOBAL: none
+// MODIFIES GL: maxEntries, maxBytes, evict
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+SplayCache<K, V, Compare, Alloc>::SplayCache(size_t entries, size_t bytes, CacheEvict how, const Compare &compare,
+	const Alloc &a) : Base(compare, a) {
+	evict = how;
+	maxEntries = entries;
+	maxBytes = bytes;
+	nBytes = 0;
+	clock = 0;
+	hits = misses = evictions = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: touch
+// DESCRIPTION: To stamp the entry at the root with a new time. Only the root's
+//				aggregate is out of date then.
+//   ARGUMENTS: CacheEntry<V> *e - the record of the root
+// USES GLOBAL: none
+// MODIFIES GL: clock
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+void SplayCache<K, V, Compare, Alloc>::touch(CacheEntry<V> *e) {
+	if (evict != EvictLRU)
+		return;
+	e->stamp = ++clock;
+	this->root->UpdateAgg();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: full
+// DESCRIPTION: To tell whether the cache is over either of its capacities.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+bool SplayCache<K, V, Compare, Alloc>::full() const {
+	return (maxEntries != 0 && (size_t)getSize() > maxEntries) || (maxBytes != 0 && nBytes > maxBytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: evictOne
+// DESCRIPTION: To splay the victim to the root and free it. The least stamp
+//				is the aggregate of the root, and every stamp is distinct, so
+//				the probe never has to guess.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, nBytes, evictions
+//     RETURNS: bool - false if the cache is empty
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+bool SplayCache<K, V, Compare, Alloc>::evictOne() {
+	CacheNode *lft, *rgt;
+	if (this->root == NULL)
+		return false;
+	if (evict == EvictLRU) {
+		StampProbe probe = { this->root->getAgg() };
+		this->root = this->splayBy(this->root, probe);
+	}
+	else {
+		DeepProbe probe;
+		this->root = this->splayBy(this->root, probe);
+	}
+	nBytes -= this->root->getRcd()->bytes;
+	lft = this->root->getLft();
+	rgt = this->root->getRgt();
+	this->freeNode(this->root);
+	this->root = this->joinNodes(lft, rgt);
+	evictions++;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: get
+// DESCRIPTION: To look up "key". A hit is splayed to the root and touched.
+//   ARGUMENTS: const K &key - the key
+// USES GLOBAL: none
+// MODIFIES GL: root, hits, misses
+//     RETURNS: V* - the value, or NULL on a miss. It stays valid until the
+//				entry is erased or evicted
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+V *SplayCache<K, V, Compare, Alloc>::get(const K &key) {
+	CacheEntry<V> *e = Base::find(key);
+	if (e == NULL) {
+		misses++;
+		return NULL;
+	}
+	hits++;
+	touch(e);
+	return &e->value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: peek
+// DESCRIPTION: To look up "key" without splaying or touching it, so neither
+//				the order of eviction nor the counters are changed.
+//   ARGUMENTS: const K &key - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: const V* - the value, or NULL
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+const V *SplayCache<K, V, Compare, Alloc>::peek(const K &key) const {
+	const CacheEntry<V> *e = Base::peek(key);
+	return e == NULL ? NULL : &e->value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: put
+// DESCRIPTION: To set the value of "key", inserting it if it is not there,
+//				then to evict until the cache fits again. The entry just put
+//				is the most recent one, so it is never the one evicted.
+//   ARGUMENTS: const K &key - the key
+//				const V &value - the value
+//				size_t bytes - what the entry is charged against the byte capacity
+// USES GLOBAL: none
+// MODIFIES GL: root, nBytes, evictions
+//     RETURNS: bool - false if the entry alone is over the byte capacity, in
+//				which case nothing is done
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+bool SplayCache<K, V, Compare, Alloc>::put(const K &key, const V &value, size_t bytes) {
+	CacheEntry<V> *e;
+	if (maxBytes != 0 && bytes > maxBytes)
+		return false;
+	e = Base::try_emplace(key).first;	// one splay either way; the entry is at the root
+	e->value = value;
+	nBytes = nBytes - e->bytes + bytes;
+	e->bytes = bytes;
+	touch(e);
+	while (full() && getSize() > 1)
+		evictOne();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: erase
+// DESCRIPTION: To take "key" out of the cache. It does not count as an eviction.
+//   ARGUMENTS: const K &key - the key
+// USES GLOBAL: none
+// MODIFIES GL: root, nBytes
+//     RETURNS: bool - false if "key" is not there
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+bool SplayCache<K, V, Compare, Alloc>::erase(const K &key) {
+	typename Base::node_type nh = Base::extract(key);	// the node is freed with the handle
+	if (nh.empty())
+		return false;
+	nBytes -= nh.mapped().bytes;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: clear
+// DESCRIPTION: To drop every entry. The counters are kept.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, nBytes
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+void SplayCache<K, V, Compare, Alloc>::clear() {
+	Base::empty();
+	nBytes = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: setCapacity
+// DESCRIPTION: To change the capacities, evicting at once down to the new ones.
+//   ARGUMENTS: size_t entries - the entry capacity, 0 for no limit
+//				size_t bytes - the byte capacity, 0 for no limit
+// USES GLOBAL: none
+// MODIFIES GL: maxEntries, maxBytes, root, nBytes, evictions
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class K, class V, class Compare, class Alloc>
+bool SplayCache<K, V, Compare, Alloc>::setCapacity(size_t entries, size_t bytes) {
+	maxEntries = entries;
+	maxBytes = bytes;
+	while (full())
+		evictOne();
+	return true;
+}
+
+#endif
@@ -0,0 +1,487 @@
+/*
+SplaySequence.h
+
+Copyright (C) 2026 SplayTree contributors
+Built on SplayTree.h, Copyright (C) 2015-2019 Kingston Chan. This file is not
+part of the original source.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+SplayTree contributors
+
+*/
+
+#ifndef SplaySEQUENCE_H
+#define SplaySEQUENCE_H
+
+#include "SplayTree.h"
+
+// the pending updates of the sons of a node in a SplaySequence
+template<class T>
+class SeqTag {
+public :
+	bool rev;		// the sons are to be reversed
+	bool hasAdd;	// "add" is to be added to the sons
+	T add;
+	SeqTag() : rev(false), hasAdd(false), add() {}
+};
+
+// positions are never compared
+template<class T>
+class PosCmp {
+public :
+	int operator()(const T &, const T &) const { return 0; }
+};
+
+// adds with operator+= on types that have it; addRange, the only way to set an
+// add tag, does not compile for the others, so their add is never called
+template<class T, class = void>
+struct SeqAdd {
+	static const bool value = false;
+	static void add(T &, const T &) {}
+};
+
+template<class T>
+struct SeqAdd<T, decltype((void)(std::declval<T&>() += std::declval<const T&>()))> {
+	static const bool value = true;
+	static void add(T &a, const T &b) { a += b; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////Splay sequence///////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A sequence kept in a Splay tree by position instead of by compare: the ID
+// of a node is the element, and its place is found from the subtree counts.
+// Range reverse and range add are lazy: a node's own element and the order of
+// its sons are always right, its tag says what is still owed to its sons, and
+// it is pushed down by the probe of the top-down splay before the sons are read.
+template<class T, class Alloc = std::allocator<T> >
+class SplaySequence : private SplayTree<T, SeqTag<T>, PosCmp<T>, Alloc> {
+
+private :
+	typedef SplayTree<T, SeqTag<T>, PosCmp<T>, Alloc> Base;
+	typedef Node<T, SeqTag<T> > SeqNode;
+
+	struct PosProbe {	// towards the node with "k" nodes before it
+		mutable int k;	// counted within the subtree of the node probed
+		int operator()(const SeqNode *node) const {
+			pushDown(const_cast<SeqNode*>(node));	// the path is pushed as it is read
+			int lc = node->getLft() == NULL ? 0 : node->getLft()->getCount();
+			if (k < lc)
+				return -1;
+			if (k == lc)
+				return 0;
+			k -= lc + 1;
+			return 1;
+		}
+	};
+
+	static void apply(SeqNode *node, bool rev, const T *add);
+	static void pushDown(SeqNode *node);
+	SeqNode* splayAt(SeqNode *node, int k);
+	SeqNode* cutAt(int k);
+	SeqNode* joinSeq(SeqNode *lft, SeqNode *rgt);
+public :
+	SplaySequence() {}
+	SplaySequence(const Alloc &a) : Base(PosCmp<T>(), a) {}
+	template<class It, class = typename std::iterator_traits<It>::iterator_category>
+	SplaySequence(It first, It last, const Alloc &a = Alloc()) : Base(PosCmp<T>(), a) { assign(first, last); }
+
+	template<class It>
+	bool assign(It first, It last) { return Base::bulkLoad(first, last); }
+	using Base::empty;
+	using Base::getSize;
+	using Base::getHeight;
+
+	const T &at(int i);
+	bool modify(int i, const T &value);
+	bool insertAt(int i, const T &value);
+	bool pushBack(const T &value) { return insertAt(getSize(), value); }
+	bool eraseRange(int first, int last);
+	bool erase(int i) { return eraseRange(i, i + 1); }
+	bool reverse(int first, int last);
+	bool addRange(int first, int last, const T &value);
+	SplaySequence<T, Alloc> split(int k);
+	bool concat(SplaySequence<T, Alloc> &b);
+	template<class Func>
+	void forEach(Func fn);
+	void swap(SplaySequence<T, Alloc> &b) { Base::swap(b); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: apply
+// DESCRIPTION: To apply a reverse and/or an add to the subtree of "node". The
+//				node's own element and the order of its sons are fixed at
+//				once; the same is recorded in its tag for the sons.
+//   ARGUMENTS: SeqNode *node - the root of the subtree, may be NULL
+//				bool rev - whether to reverse the subtree
+//				const T *add - the value to add, NULL for none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+void SplaySequence<T, Alloc>::apply(SeqNode *node, bool rev, const T *add) {
+	SeqTag<T> *tag;
+	SeqNode *tmp;
+	if (node == NULL)
+		return;
+	tag = node->getRcd();
+	if (add != NULL) {
+		T value = node->getID();
+		SeqAdd<T>::add(value, *add);
+		node->ModifyID(value);
+		if (tag->hasAdd)
+			SeqAdd<T>::add(tag->add, *add);
+		else
+			tag->add = *add;
+		tag->hasAdd = true;
+	}
+	if (rev) {
+		tmp = node->getLft();
+		node->AddLft(node->getRgt());
+		node->AddRgt(tmp);
+		tag->rev = !tag->rev;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: pushDown
+// DESCRIPTION: To hand the tag of a node on to its sons and clear it.
+//   ARGUMENTS: SeqNode *node - the node
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+void SplaySequence<T, Alloc>::pushDown(SeqNode *node) {
+	SeqTag<T> *tag = node->getRcd();
+	if (!tag->rev && !tag->hasAdd)
+		return;
+	apply(node->getLft(), tag->rev, tag->hasAdd ? &tag->add : NULL);
+	apply(node->getRgt(), tag->rev, tag->hasAdd ? &tag->add : NULL);
+	tag->rev = false;
+	tag->hasAdd = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: splayAt
+// DESCRIPTION: To splay the node at position "k" of a subtree to its root.
+//   ARGUMENTS: SeqNode *node - the root of the subtree
+//				int k - the position, 0 <= k < the size of the subtree
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: SeqNode* - the new root of the subtree
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+typename SplaySequence<T, Alloc>::SeqNode* SplaySequence<T, Alloc>::splayAt(SeqNode *node, int k) {
+	PosProbe probe = { k };
+	return this->splayBy(node, probe);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: cutAt
+// DESCRIPTION: To cut the elements from position "k" on off the tree.
+//   ARGUMENTS: int k - the first position cut off
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: SeqNode* - the root of the part cut off (parent NULL)
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+typename SplaySequence<T, Alloc>::SeqNode* SplaySequence<T, Alloc>::cutAt(int k) {
+	SeqNode *rgt;
+	if (k >= getSize())
+		return NULL;
+	if (k <= 0) {
+		rgt = this->root;
+		this->root = NULL;
+		return rgt;
+	}
+	rgt = this->root = splayAt(this->root, k);	// the root goes right
+	this->root = rgt->getLft();
+	rgt->AddLft((SeqNode*)NULL);
+	this->root->ModifyPar((SeqNode*)NULL);
+	return rgt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: joinSeq
+// DESCRIPTION: To put the elements of "rgt" after those of "lft". The last
+//				element of "lft" is splayed up and "rgt" hung on its right.
+//   ARGUMENTS: SeqNode *lft - the root of the left part
+//				SeqNode *rgt - the root of the right part
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: SeqNode* - the root of the joined tree
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+typename SplaySequence<T, Alloc>::SeqNode* SplaySequence<T, Alloc>::joinSeq(SeqNode *lft, SeqNode *rgt) {
+	if (lft == NULL) {
+		if (rgt != NULL)
+			rgt->ModifyPar((SeqNode*)NULL);
+		return rgt;
+	}
+	lft->ModifyPar((SeqNode*)NULL);
+	lft = splayAt(lft, lft->getCount() - 1);
+	lft->AddRgt(rgt);
+	return lft;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: at
+// DESCRIPTION: To get the element at position "i". The node is splayed to
+//				the root.
+//   ARGUMENTS: int i - the position
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: const T& - valid until the sequence is changed
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+const T &SplaySequence<T, Alloc>::at(int i) {
+	if (i < 0 || i >= getSize())
+		throw SplayERR("Index out of range");
+	this->root = splayAt(this->root, i);
+	return this->root->getID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: modify
+// DESCRIPTION: To set the element at position "i".
+//   ARGUMENTS: int i - the position
+//				const T &value - the new element
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if "i" is out of range
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::modify(int i, const T &value) {
+	if (i < 0 || i >= getSize())
+		return false;
+	this->root = splayAt(this->root, i);
+	return this->root->ModifyID(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insertAt
+// DESCRIPTION: To insert an element before position "i", so that it becomes
+//				the element at "i". The node at "i" (or the last node) is
+//				splayed up and the new node linked in above it.
+//   ARGUMENTS: int i - the position, 0 <= i <= the size
+//				const T &value - the new element
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if "i" is out of range
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::insertAt(int i, const T &value) {
+	int n = getSize();
+	if (i < 0 || i > n)
+		return false;
+	SeqNode *node = this->newNode(value);
+	if (n > 0) {
+		if (i < n) {
+			this->root = splayAt(this->root, i);
+			this->linkRoot(node, -1);
+		}
+		else {
+			this->root = splayAt(this->root, n - 1);
+			this->linkRoot(node, 1);
+		}
+	}
+	else
+		this->linkRoot(node, 0);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: eraseRange
+// DESCRIPTION: To erase the elements at positions [first, last).
+//   ARGUMENTS: int first - the first position erased
+//				int last - the position just after the range
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if the range is out of the sequence
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::eraseRange(int first, int last) {
+	SeqNode *rgt;
+	if (first < 0 || last > getSize() || first > last)
+		return false;
+	if (first == last)
+		return true;
+	rgt = cutAt(last);
+	this->freeTree(cutAt(first));
+	this->root = joinSeq(this->root, rgt);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: reverse
+// DESCRIPTION: To reverse the elements at positions [first, last). The range
+//				is cut out, tagged at its root and put back.
+//   ARGUMENTS: int first - the first position
+//				int last - the position just after the range
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if the range is out of the sequence
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::reverse(int first, int last) {
+	SeqNode *mid, *rgt;
+	if (first < 0 || last > getSize() || first > last)
+		return false;
+	if (last - first < 2)
+		return true;
+	rgt = cutAt(last);
+	mid = cutAt(first);
+	apply(mid, true, NULL);
+	this->root = joinSeq(joinSeq(this->root, mid), rgt);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: addRange
+// DESCRIPTION: To add "value" to the elements at positions [first, last),
+//				with operator+= of T; without it this does not compile.
+//   ARGUMENTS: int first - the first position
+//				int last - the position just after the range
+//				const T &value - the value to add
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if the range is out of the sequence
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::addRange(int first, int last, const T &value) {
+	static_assert(SeqAdd<T>::value, "addRange needs T::operator+=");
+	SeqNode *mid, *rgt;
+	if (first < 0 || last > getSize() || first > last)
+		return false;
+	if (first == last)
+		return true;
+	rgt = cutAt(last);
+	mid = cutAt(first);
+	apply(mid, false, &value);
+	this->root = joinSeq(joinSeq(this->root, mid), rgt);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: split
+// DESCRIPTION: To move the elements from position "k" on into a new sequence
+//				that is returned. Nothing is allocated or copied.
+//   ARGUMENTS: int k - the first position moved
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: SplaySequence<T, Alloc>
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+SplaySequence<T, Alloc> SplaySequence<T, Alloc>::split(int k) {
+	SplaySequence<T, Alloc> right(Alloc(this->alloc));
+	right.root = cutAt(k);
+	return right;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: concat
+// DESCRIPTION: To move all the elements of "b" to the end of this sequence.
+//				The nodes are only copied if the two allocators differ.
+//   ARGUMENTS: SplaySequence<T, Alloc> &b - left empty
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+bool SplaySequence<T, Alloc>::concat(SplaySequence<T, Alloc> &b) {
+	if (&b == this)
+		return false;
+	this->root = joinSeq(this->root, this->adopt(b));
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: forEach
+// DESCRIPTION: To call "fn" on every element in order. The tags are pushed
+//				down on the way; the walk keeps a stack of the nodes whose
+//				right subtree is still to be visited.
+//   ARGUMENTS: Func fn - called as fn(const T &)
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T, class Alloc>
+template<class Func>
+void SplaySequence<T, Alloc>::forEach(Func fn) {
+	std::vector<SeqNode*> stk;
+	SeqNode *node = this->root;
+	while (node != NULL || !stk.empty()) {
+		while (node != NULL) {
+			pushDown(node);
+			stk.push_back(node);
+			node = node->getLft();
+		}
+		node = stk.back();
+		stk.pop_back();
+		fn(node->getID());
+		node = node->getRgt();
+	}
+}
+
+#endif
@@ -25,6 +25,12 @@ Kingston Chan
 
 */
 
+/*
+This is an altered version of SplayTree.h. Functions added or changed by the
+SplayTree contributors are marked "SC" in their AUTHOR/DATE lines; functions
+marked "KC" only are as Kingston Chan wrote them.
+*/
+
 #ifndef SplayTREE_H
 #define SplayTREE_H
 
@@ -32,11 +38,26 @@ Kingston Chan
 #include <fstream>
 #include <string>
 #include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <memory>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#ifdef SPLAY_PARALLEL_SORT	// needs a parallel STL (with libstdc++, link against TBB)
+#include <execution>
+#endif
 
 using namespace std;
 
 class NULLT {};
 
+// tags for the in-place constructors of Node
+class EmplaceID {};		// the arguments build the ID, the record is default
+class EmplaceRcd {};	// the first argument is the ID, the rest build the record
+
 class NodeERR {	// used to throw out when error occurs
 public :
 	std::string error;
@@ -55,6 +76,45 @@ public :
 	}
 };
 
+// how SplayTree::find restructures the tree, see setSplayMode
+enum SplayMode {
+	SplayFull,		// splay the node found to the root, top-down
+	SplaySemi,		// semi-splay bottom-up, which about halves the path
+	SplayDepth,		// splay only when the node is deeper than a threshold
+	SplayRandom		// splay with a probability, otherwise just search
+};
+
+// A snapshot of the counters a SplayTree keeps when SPLAY_STATS is defined
+// (see getStats). A call made of other calls, like equal_range or merge,
+// counts as its parts.
+struct SplayStats {
+	enum Op {
+		OpFind,		// find and the IDs of findBatch (not peek, see there)
+		OpInsert,	// Insert, emplace, try_emplace (so insert, upsert...) and the items of insertBatch
+		OpDelete,	// Delete and the IDs of deleteBatch
+		OpOrdered,	// lower_bound, upper_bound, rank and select
+		OpReshape,	// bulkLoad, split and join
+		OpCount
+	};
+	unsigned long long ops[OpCount];
+	unsigned long long compares;	// calls of the compare policy
+	unsigned long long cases[7];	// splay steps by the case of judgeCase: 0 stop, 1 zig, 2 zag,
+									// 3 zig-zig, 4 zag-zag, 5 zig-zag, 6 zag-zig
+	unsigned long long links;		// child links written by splays
+	unsigned long long rotations;	// a zig-zig or zig-zag counts two, a half step of a semi-splay one
+	unsigned long long depths[32];	// access paths by depth d: entry k counts 2^k <= d + 1 < 2^(k+1)
+	unsigned long long allocs;		// nodes allocated
+	unsigned long long frees;		// nodes freed
+	int maxDepth;					// the height of the tree when the snapshot was taken
+	SplayStats() : ops(), compares(0), cases(), links(0), rotations(0), depths(), allocs(0), frees(0), maxDepth(0) {}
+};
+
+#if defined(__GNUC__)	// a hint only, so it is left out where it is not known
+#define SPLAY_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define SPLAY_PREFETCH(p) ((void)0)
+#endif
+
 inline int MAX(int a, int b) {
 	return a > b ? a : b;
 }
@@ -68,43 +128,147 @@ int dCmp(const T1 &a, const T1 &b) {
 	return 0;
 }
 
+// compare policies for SplayTree: int operator()(a, b) returns >0, <0 or 0
+template<typename T1>
+class PtrCmp {	// calls a compare function through a pointer that can be reset at run time
+public :
+	int(*f)(const T1 &a, const T1 &b);
+	PtrCmp(int(*compare)(const T1 &a, const T1 &b) = dCmp) {
+		f = compare;
+	}
+	int operator()(const T1 &a, const T1 &b) const { return f(a, b); }
+};
+
+template<typename T1>
+class DefCmp {	// the same as dCmp, but can be inlined
+public :
+	int operator()(const T1 &a, const T1 &b) const { return dCmp(a, b); }
+};
+
+template<typename T1, class Less = std::less<T1> >
+class LessCmp : private Less {	// adapts a std::less style predicate
+public :
+	LessCmp(const Less &less = Less()) : Less(less) {}
+	int operator()(const T1 &a, const T1 &b) const {
+		if (Less::operator()(a, b))
+			return -1;
+		if (Less::operator()(b, a))
+			return 1;
+		return 0;
+	}
+};
+
+// holds the record inside the node; an empty record type (like NULLT) takes no space
+template<class T2, bool = std::is_empty<T2>::value && !std::is_final<T2>::value>
+class RcdHolder {
+protected :
+	mutable T2 Rcd;	// record
+	RcdHolder() : Rcd() {}	// value-initialized, so a plain int record starts at 0
+	RcdHolder(const T2 &rcd) : Rcd(rcd) {}
+	template<class... Args>
+	RcdHolder(EmplaceRcd, Args&&... args) : Rcd(std::forward<Args>(args)...) {}
+	T2 *rcdPtr() const { return &Rcd; }
+};
+
+template<class T2>
+class RcdHolder<T2, true> : private T2 {
+protected :
+	RcdHolder() {}
+	RcdHolder(const T2 &rcd) : T2(rcd) {}
+	template<class... Args>
+	RcdHolder(EmplaceRcd, Args&&... args) : T2(std::forward<Args>(args)...) {}
+	T2 *rcdPtr() const { return const_cast<T2*>(static_cast<const T2*>(this)); }
+};
+
+// The augment policy keeps an aggregate of every subtree. A policy gives
+//	typedef ... value_type;
+//	static value_type identity();	// the aggregate of nothing
+//	static value_type lift(const T1 &id, const T2 &rcd);	// of a single node
+//	static value_type combine(const value_type &a, const value_type &b);
+// "combine" must be associative; it is called in the in-order of the IDs.
+class NoAugment {	// no aggregate, and no space taken in the nodes
+public :
+	typedef NULLT value_type;
+};
+
+// holds the aggregate of the subtree inside the node
+template<class Augment>
+class AugHolder {
+protected :
+	typedef typename Augment::value_type value_type;
+	value_type Agg;	// aggregate of the subtree
+	const value_type *aggPtr() const { return &Agg; }
+	void setAgg(const value_type &agg) { Agg = agg; }
+	template<class T1, class T2>
+	void pullAgg(const T1 &id, const T2 &rcd, const value_type *lft, const value_type *rgt) {
+		Agg = Augment::lift(id, rcd);
+		if (lft != NULL)
+			Agg = Augment::combine(*lft, Agg);
+		if (rgt != NULL)
+			Agg = Augment::combine(Agg, *rgt);
+	}
+};
+
+template<>
+class AugHolder<NoAugment> {
+protected :
+	const NULLT *aggPtr() const {
+		static const NULLT none;
+		return &none;
+	}
+	void setAgg(const NULLT &) {}
+	template<class T1, class T2>
+	void pullAgg(const T1 &, const T2 &, const NULLT *, const NULLT *) {}
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////Tree node/////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2 = NULLT>
-class Node {
+template<class T1, class T2 = NULLT, class Augment = NoAugment>
+class Node : private RcdHolder<T2>, private AugHolder<Augment> {
 
 private:
+	Node *Lft, *Rgt;	// pointers first, so that a small ID packs with height
+	Node *Par;			// parent, kept by AddLft and AddRgt; NULL for a root
 	T1 ID;
-	T2 *Rcd;	// record
-	Node *Lft, *Rgt;
 	int height;
+	int count;			// number of nodes in the subtree, this one included
 
 public:
 	// constructor and destructor
 	Node();
 	Node(const T1 &id, const T2 * const rcd = NULL);
 	Node(const T1 &id, const T2 &rcd);
-	Node(const Node<T1, T2> &New);
+	Node(const Node<T1, T2, Augment> &New);
+	template<class... Args>
+	Node(EmplaceID, Args&&... args);
+	template<class K, class... Args>
+	Node(EmplaceRcd, K &&id, Args&&... args);
 	~Node();
 
 	// modify the info of private members
 	bool ModifyID(const T1 &tmp);
 	bool ModifyHeight(int h);
-	bool operator=(const Node<T1, T2> &b);
+	bool ModifyCount(int n);
+	bool ModifyAgg(const typename Augment::value_type &agg);
+	bool UpdateAgg();
+	bool ModifyPar(Node<T1, T2, Augment> *par);
+	bool operator=(const Node<T1, T2, Augment> &b);
 	bool operator=(const T1 &id);
-	bool copy(const Node<T1, T2> * const b);
-	bool AddLft(Node<T1, T2> *lft);
-	bool AddRgt(Node<T1, T2> *rgt);
-	bool AddLft(const T1 &lftID, const T2 * const lftRcd = NULL);
-	bool AddRgt(const T1 &rgtID, const T2 * const RgtRcd = NULL);
+	bool AddLft(Node<T1, T2, Augment> *lft);
+	bool AddRgt(Node<T1, T2, Augment> *rgt);
 
 	// get the info of private members
-	Node<T1, T2> *getLft() const { return Lft; }
-	Node<T1, T2> *getRgt() const { return Rgt; }
+	Node<T1, T2, Augment> *getLft() const { return Lft; }
+	Node<T1, T2, Augment> *getRgt() const { return Rgt; }
+	Node<T1, T2, Augment> *getPar() const { return Par; }
+	Node<T1, T2, Augment> *getNext() const;
+	Node<T1, T2, Augment> *getPrev() const;
 	int getHeight() const { return height; }
+	int getCount() const { return count; }
+	const typename Augment::value_type &getAgg() const { return *this->aggPtr(); }
 	const T1 &getID() const { return ID; }
-	T2 *getRcd() const { return Rcd; }
+	T2 *getRcd() const { return this->rcdPtr(); }
 	void print() const;
 };
 
@@ -113,19 +277,18 @@ public:
 // DESCRIPTION: Constructor of Node class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: height, Rcd, Lft, Rgt
+// MODIFIES GL: height, count, Agg, Lft, Rgt
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node() {
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment>::Node() {
 	height = 0;
-	Rcd = new T2;
-	if (Rcd == NULL)
-		throw NodeERR("Out of space");
-	Lft = Rgt = NULL;
+	count = 1;
+	Lft = Rgt = Par = NULL;
+	UpdateAgg();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,22 +297,20 @@ Node<T1, T2>::Node() {
 //   ARGUMENTS: const T1 &id - the ID of the node
 //				const T2 * const rcd - the initial record with default value NULL
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, count, Agg, Lft, Rgt
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const T1 &id, const T2 * const rcd) {
-	ID = id;
-	Rcd = new T2;
-	if (Rcd == NULL)
-		throw NodeERR("Out of space");
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment>::Node(const T1 &id, const T2 * const rcd) : ID(id) {
 	if (rcd != NULL)
-		*Rcd = *rcd;
-	Lft = Rgt = NULL;	// no sons at first
+		*getRcd() = *rcd;
+	Lft = Rgt = Par = NULL;	// no sons at first
 	height = 0;
+	count = 1;
+	UpdateAgg();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -158,58 +319,99 @@ Node<T1, T2>::Node(const T1 &id, const T2 * const rcd) {
 //   ARGUMENTS: const T1 &id - the ID of the node
 //				const T2 &rcd - the initial record
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, count, Agg, Lft, Rgt
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const T1 &id, const T2 &rcd) {
-	ID = id;
-	Rcd = new T2;
-	if (Rcd == NULL)
-		throw NodeERR("Out of space");
-	*Rcd = rcd;
-	Lft = Rgt = NULL;	// no sons at first
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment>::Node(const T1 &id, const T2 &rcd) : RcdHolder<T2>(rcd), ID(id) {
+	Lft = Rgt = Par = NULL;	// no sons at first
 	height = 0;
+	count = 1;
+	UpdateAgg();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: Node
-// DESCRIPTION: Copy constructor of Node class.
-//   ARGUMENTS: const Node<T1, T2> &New - the Node that is to be copied
+// DESCRIPTION: Copy constructor of Node class. Only the ID and the record
+//				are copied: the sons belong to the tree and its allocator, so
+//				the copy is a single node with no sons.
+//   ARGUMENTS: const Node<T1, T2, Augment> &New - the Node that is to be copied
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, count, Agg, Lft, Rgt
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment>::Node(const Node<T1, T2, Augment> &New) : RcdHolder<T2>(*New.getRcd()), ID(New.ID) {
+	Lft = Rgt = Par = NULL;
+	height = 0;
+	count = 1;
+	UpdateAgg();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Node
+// DESCRIPTION: Constructor of Node class that builds the ID in place.
+//   ARGUMENTS: EmplaceID - the tag
+//				Args&&... args - the arguments for the constructor of T1
+// USES GLOBAL: none
+// MODIFIES GL: ID, Rcd, height, count, Agg, Lft, Rgt
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+template<class... Args>
+Node<T1, T2, Augment>::Node(EmplaceID, Args&&... args) : ID(std::forward<Args>(args)...) {
+	Lft = Rgt = Par = NULL;	// no sons at first
+	height = 0;
+	count = 1;
+	UpdateAgg();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const Node<T1, T2> &New) {
-	copy(&New);
+//        NAME: Node
+// DESCRIPTION: Constructor of Node class that builds the record in place.
+//   ARGUMENTS: EmplaceRcd - the tag
+//				K &&id - the ID of the node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: ID, Rcd, height, count, Agg, Lft, Rgt
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+template<class K, class... Args>
+Node<T1, T2, Augment>::Node(EmplaceRcd, K &&id, Args&&... args)
+	: RcdHolder<T2>(EmplaceRcd(), std::forward<Args>(args)...), ID(std::forward<K>(id)) {
+	Lft = Rgt = Par = NULL;	// no sons at first
+	height = 0;
+	count = 1;
+	UpdateAgg();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: ~Node
-// DESCRIPTION: Destructor of Node class.
+// DESCRIPTION: Destructor of Node class. A node does not own its sons: they
+//				were made by the allocator of the tree, which frees them.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: none
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::~Node() {
-	if (Rcd != NULL)
-		delete Rcd;
-	if (Lft != NULL)
-		delete Lft;
-	if (Rgt != NULL)
-		delete Rgt;
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment>::~Node() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -221,10 +423,10 @@ Node<T1, T2>::~Node() {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::ModifyID(const T1 &tmp) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::ModifyID(const T1 &tmp) {
 	ID = tmp;
 	return true;
 }
@@ -238,109 +440,157 @@ bool Node<T1, T2>::ModifyID(const T1 &tmp) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::ModifyHeight(int h) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::ModifyHeight(int h) {
 	height = h;
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: copy
-// DESCRIPTION: To copy the node and their sons.
-//   ARGUMENTS: const Node<T1, T2> * const b - the new node that is to be copied
+//        NAME: ModifyCount
+// DESCRIPTION: To modify the number of nodes in the subtree of a Node.
+//   ARGUMENTS: int n - the new count value
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, Lft, Rgt, height
+// MODIFIES GL: count
 //     RETURNS: bool
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-08
-//							KC 2015-02-08
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::copy(const Node<T1, T2> * const b) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::ModifyCount(int n) {
+	count = n;
+	return true;
+}
 
-	// avoid self copy after deletion
-	if (b == this)
-		return true;
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ModifyAgg
+// DESCRIPTION: To modify the aggregate of the subtree of a Node.
+//   ARGUMENTS: const typename Augment::value_type &agg - the new aggregate
+// USES GLOBAL: none
+// MODIFIES GL: Agg
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::ModifyAgg(const typename Augment::value_type &agg) {
+	this->setAgg(agg);
+	return true;
+}
 
-	// copy ID, record and height
-	ID = b->ID;
-	if (b->Rcd != NULL) {
-		if (Rcd == NULL) {
-			Rcd = new T2;
-			if (Rcd == NULL) {
-				throw NodeERR("Out of space");
-				return false;
-			}
-		}
-		*Rcd = *(b->Rcd);
-	}
-	else {
-		if (Rcd != NULL) {
-			delete Rcd;
-			Rcd = NULL;
-		}
-	}
-	height = b->height;
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: UpdateAgg
+// DESCRIPTION: To recompute the aggregate of a Node from its own ID and
+//				record and the aggregates of its sons. Nothing is done
+//				with NoAugment.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: Agg
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::UpdateAgg() {
+	this->pullAgg(ID, *getRcd(), Lft == NULL ? NULL : Lft->aggPtr(), Rgt == NULL ? NULL : Rgt->aggPtr());
+	return true;
+}
 
-	// copy the left son
-	if (b->Lft != NULL) {
-		if (Lft == NULL) {
-			Lft = new Node<T1, T2>;
-			if (Lft == NULL) {
-				throw NodeERR("Out of space");
-				return false;
-			}
-		}
-		Lft->copy(b->Lft);
-	}
-	else {
-		if (Lft != NULL) {
-			delete Lft;
-			Lft = NULL;
-		}
-	}
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ModifyPar
+// DESCRIPTION: To modify the parent of a Node. AddLft and AddRgt keep it for
+//				the sons; this is for a node that becomes a root.
+//   ARGUMENTS: Node<T1, T2, Augment> *par - the new parent
+// USES GLOBAL: none
+// MODIFIES GL: Par
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::ModifyPar(Node<T1, T2, Augment> *par) {
+	Par = par;
+	return true;
+}
 
-	// copy the right son
-	if (b->Rgt != NULL) {
-		if (Rgt == NULL) {
-			Rgt = new Node<T1, T2>;
-			if (Rgt == NULL) {
-				throw NodeERR("Out of space");
-				return false;
-			}	
-		}
-		Rgt->copy(b->Rgt);
-	}
-	else {
-		if (Rgt != NULL) {
-			delete Rgt;
-			Rgt = NULL;
-		}
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getNext
+// DESCRIPTION: To find the in-order successor of a Node through the parent
+//				links, without changing the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>* - NULL for the last node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment> *Node<T1, T2, Augment>::getNext() const {
+	const Node<T1, T2, Augment> *node = this;
+	if (node->Rgt != NULL) {
+		node = node->Rgt;
+		while (node->Lft != NULL)
+			node = node->Lft;
+		return const_cast<Node<T1, T2, Augment>*>(node);
 	}
+	while (node->Par != NULL && node->Par->Rgt == node)
+		node = node->Par;
+	return node->Par;
+}
 
-	return true;
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getPrev
+// DESCRIPTION: To find the in-order predecessor of a Node through the parent
+//				links, without changing the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>* - NULL for the first node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+Node<T1, T2, Augment> *Node<T1, T2, Augment>::getPrev() const {
+	const Node<T1, T2, Augment> *node = this;
+	if (node->Lft != NULL) {
+		node = node->Lft;
+		while (node->Rgt != NULL)
+			node = node->Rgt;
+		return const_cast<Node<T1, T2, Augment>*>(node);
+	}
+	while (node->Par != NULL && node->Par->Lft == node)
+		node = node->Par;
+	return node->Par;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: operator=
 // DESCRIPTION: copy the content of a Node.
-//   ARGUMENTS: const Node<T1, T2> &b - the Node that is to be assigned
+//   ARGUMENTS: const Node<T1, T2, Augment> &b - the Node that is to be assigned
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height
+// MODIFIES GL: ID, Rcd, height, count, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::operator=(const Node<T1, T2> &b) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::operator=(const Node<T1, T2, Augment> &b) {
 	if (&b == this)
 		return true;
 	ID = b.getID();
-	*Rcd = *(b.getRcd());
+	*getRcd() = *(b.getRcd());
 	height = b.getHeight();
+	count = b.getCount();
+	this->setAgg(b.getAgg());
 	return true;
 }
 
@@ -353,10 +603,10 @@ bool Node<T1, T2>::operator=(const Node<T1, T2> &b) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::operator=(const T1 &id) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::operator=(const T1 &id) {
 	ID = id;
 	return true;
 }
@@ -364,185 +614,605 @@ bool Node<T1, T2>::operator=(const T1 &id) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AddLft
 // DESCRIPTION: Concatenate a left son.
-//   ARGUMENTS: Node<T1, T2> *lft - the left son that is to be concatenated
+//   ARGUMENTS: Node<T1, T2, Augment> *lft - the left son that is to be concatenated
 // USES GLOBAL: none
-// MODIFIES GL: Lft, height
+// MODIFIES GL: Lft, height, count, Agg, Lft->Par
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddLft(Node<T1, T2> *lft) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::AddLft(Node<T1, T2, Augment> *lft) {
 
 	Lft = lft; // assign the left son
+	if (Lft != NULL)
+		Lft->Par = this;
 
-	// update the height
+	// update the height, the count and the aggregate
 	height = 0;
-	if (Lft != NULL)
+	count = 1;
+	if (Lft != NULL) {
 		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
+		count += Lft->count;
+	}
+	if (Rgt != NULL) {
 		height = MAX(height, Rgt->height + 1);
+		count += Rgt->count;
+	}
+	UpdateAgg();
 
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: AddLft
-// DESCRIPTION: Concatenate a left son.
-//   ARGUMENTS: const T1 &lftID - the ID of the left son that is to be concatenated
-//				const T2 * const lftRcd - the record of the left son
+//        NAME: AddRgt
+// DESCRIPTION: Concatenate a right son.
+//   ARGUMENTS: Node<T1, T2, Augment> *rgt - the right son that is to be concatenated
 // USES GLOBAL: none
-// MODIFIES GL: Lft, height
+// MODIFIES GL: Rgt, height, count, Agg, Rgt->Par
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddLft(const T1 &lftID, const T2 * const lftRcd) {
+template<class T1, class T2, class Augment>
+bool Node<T1, T2, Augment>::AddRgt(Node<T1, T2, Augment> *rgt) {
 
-	Node *Tmp = new Node(lftID, lftRcd);
-	if (Tmp == NULL) {
-		throw NodeERR("Out of space");
-		return false;
-	}
-	Lft = Tmp;
+	Rgt = rgt; // assign the right son
+	if (Rgt != NULL)
+		Rgt->Par = this;
 
-	// update the height
+	// update the height, the count and the aggregate
 	height = 0;
-	if (Lft != NULL)
+	count = 1;
+	if (Lft != NULL) {
 		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
+		count += Lft->count;
+	}
+	if (Rgt != NULL) {
 		height = MAX(height, Rgt->height + 1);
+		count += Rgt->count;
+	}
+	UpdateAgg();
 
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: AddRgt
-// DESCRIPTION: Concatenate a right son.
-//   ARGUMENTS: Node<T1, T2> *rgt - the right son that is to be concatenated
+//        NAME: print
+// DESCRIPTION: To print the Node's ID, height and two sons, and then the same
+//				for its subtree in pre-order.
+//   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: Rgt, height
-//     RETURNS: bool
+// MODIFIES GL: none
+//     RETURNS: void
 //      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddRgt(Node<T1, T2> *rgt) {
+// AUTHOR/DATE: KC 2015-02-11
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Augment>
+void Node<T1, T2, Augment>::print() const{
+	std::vector<const Node<T1, T2, Augment>*> stk;	// right sons still to print
+	const Node<T1, T2, Augment> *node = this;
+	while (node != NULL) {
+		cout << node->ID << ": h-" << node->height << "  l-";
+		if (node->Lft != NULL)
+			cout << '(' << node->Lft->getID() << ')';
+		cout << "  r-";
+		if (node->Rgt != NULL)
+			cout << '(' << node->Rgt->getID() << ')';
+		cout << endl;
+		if (node->Lft != NULL) {
+			if (node->Rgt != NULL)
+				stk.push_back(node->Rgt);
+			node = node->Lft;
+		}
+		else
+			node = node->Rgt;
+		if (node == NULL && !stk.empty()) {
+			node = stk.back();
+			stk.pop_back();
+		}
+	}
+}
 
-	Rgt = rgt; // assign the left son
+////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////Node pool/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+// An arena of equal sized blocks carved out of slabs. Freed blocks go to a free
+// list and are handed out again before a new slab is taken. The block size is
+// fixed by the first allocation.
+class PoolArena {
 
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+private :
+	struct Block { Block *next; };
+	struct Slab { Slab *next; };
+
+	size_t bsize;		// block size, 0 before the first allocation
+	size_t nxtCount;	// number of blocks in the next slab
+	Slab *slabs;
+	Block *freeList;
+	char *cur, *end;	// the unused part of the newest slab
+
+	static size_t roundUp(size_t n) {
+		const size_t a = alignof(std::max_align_t);
+		return (n + a - 1) / a * a;
+	}
+	void newSlab();
 
-	return true;
-}
+public :
+	PoolArena() {
+		bsize = 0;
+		nxtCount = 32;
+		slabs = NULL;
+		freeList = NULL;
+		cur = end = NULL;
+	}
+	~PoolArena() { release(); }
+
+	bool fits(size_t bytes) const { return bsize == 0 || roundUp(bytes) == bsize; }
+	void *allocate(size_t bytes);
+	void deallocate(void *p);
+	void release();
+};
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: AddRgt
-// DESCRIPTION: Concatenate a right son.
-//   ARGUMENTS: const T1 &rgtID - the ID of the right son that is to be concatenated
-//				const T2 * const RgtRcd - the record of the right son
+//        NAME: newSlab
+// DESCRIPTION: To take a new slab for the arena. Slabs double in size up to
+//				8192 blocks.
+//   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: Rgt, height
-//     RETURNS: bool
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddRgt(const T1 &rgtID, const T2 * const RgtRcd = NULL) {
+// MODIFIES GL: slabs, cur, end, nxtCount
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+inline void PoolArena::newSlab() {
+	size_t hdr = roundUp(sizeof(Slab));
+	Slab *slab = static_cast<Slab*>(::operator new(hdr + nxtCount * bsize));
+	slab->next = slabs;
+	slabs = slab;
+	cur = reinterpret_cast<char*>(slab) + hdr;
+	end = cur + nxtCount * bsize;
+	if (nxtCount < 8192)
+		nxtCount *= 2;
+}
 
-	Node *Tmp = new Node(rgtID, RgtRcd);
-	if (Tmp == NULL) {
-		throw NodeERR("Out of space");
-		return false;
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: allocate
+// DESCRIPTION: To get a block from the free list, or from the newest slab.
+//   ARGUMENTS: size_t bytes - the size of the block
+// USES GLOBAL: none
+// MODIFIES GL: bsize, freeList, cur
+//     RETURNS: void*
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+inline void *PoolArena::allocate(size_t bytes) {
+	void *p;
+	if (bsize == 0)
+		bsize = roundUp(bytes < sizeof(Block) ? sizeof(Block) : bytes);
+	if (freeList != NULL) {
+		p = freeList;
+		freeList = freeList->next;
+		return p;
 	}
-	Rgt = Tmp;
-
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+	if (cur == end)
+		newSlab();
+	p = cur;
+	cur += bsize;
+	return p;
+}
 
-	return true;
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: deallocate
+// DESCRIPTION: To give a block back to the free list.
+//   ARGUMENTS: void *p - the block
+// USES GLOBAL: none
+// MODIFIES GL: freeList
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+inline void PoolArena::deallocate(void *p) {
+	Block *b = static_cast<Block*>(p);
+	b->next = freeList;
+	freeList = b;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: print
-// DESCRIPTION: To print the Node's ID, height and two sons.
+//        NAME: release
+// DESCRIPTION: To give all the slabs back at once, whatever is still in them.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: none
+// MODIFIES GL: slabs, freeList, cur, end, nxtCount
 //     RETURNS: void
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-11
-//							KC 2015-02-11
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-void Node<T1, T2>::print() const{
-	cout << ID << ": h-" << height << "  l-";
-	if (Lft != NULL)
-		cout << '(' << Lft->getID() << ')';
-	cout << "  r-";
-	if (Rgt != NULL)
-		cout << '(' << Rgt->getID() << ')';
-	cout << endl;
-	if (Lft != NULL)
-		Lft->print();
-	if (Rgt != NULL)
-		Rgt->print();
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+inline void PoolArena::release() {
+	while (slabs != NULL) {
+		Slab *nxt = slabs->next;
+		::operator delete(slabs);
+		slabs = nxt;
+	}
+	freeList = NULL;
+	cur = end = NULL;
+	nxtCount = 32;
 }
 
+// A standard allocator on top of a PoolArena. Copies share the arena; a
+// container copy gets an arena of its own. Only single blocks of the arena's
+// size come from the arena, everything else goes to operator new.
+template<class T>
+class PoolAlloc {
+
+	template<class U> friend class PoolAlloc;
+	std::shared_ptr<PoolArena> arena;
+
+public :
+	typedef T value_type;
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	PoolAlloc() : arena(std::make_shared<PoolArena>()) {}
+	template<class U>
+	PoolAlloc(const PoolAlloc<U> &other) : arena(other.arena) {}
+
+	T *allocate(size_t n) {
+		if (n == 1 && arena->fits(sizeof(T)))
+			return static_cast<T*>(arena->allocate(sizeof(T)));
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+	void deallocate(T *p, size_t n) {
+		if (n == 1 && arena->fits(sizeof(T)))
+			arena->deallocate(p);
+		else
+			::operator delete(p);
+	}
+	PoolAlloc select_on_container_copy_construction() const { return PoolAlloc(); }
+
+	// drops every block at once; refused while another allocator shares the arena
+	bool release() {
+		if (arena.use_count() != 1)
+			return false;
+		arena->release();
+		return true;
+	}
+
+	template<class U>
+	bool operator==(const PoolAlloc<U> &b) const { return arena == b.arena; }
+	template<class U>
+	bool operator!=(const PoolAlloc<U> &b) const { return arena != b.arena; }
+};
+
+// calls release() on allocators that have it
+template<class A, class = void>
+struct AllocRelease {
+	static bool release(A &) { return false; }
+};
+
+template<class A>
+struct AllocRelease<A, decltype((void)std::declval<A&>().release())> {
+	static bool release(A &a) { return a.release(); }
+};
+
+// A bidirectional in-order iterator over the nodes of a Splay tree. It follows
+// the parent links and never splays, so walking the tree does not change it.
+template<class T1, class T2, class Augment>
+class SplayIterator {
+
+private :
+	Node<T1, T2, Augment> *node;			// NULL for end()
+	Node<T1, T2, Augment> * const *root;	// the root of the tree, to step back from end()
+
+public :
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Node<T1, T2, Augment> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const Node<T1, T2, Augment> *pointer;
+	typedef const Node<T1, T2, Augment> &reference;
+
+	SplayIterator() : node(NULL), root(NULL) {}
+	SplayIterator(Node<T1, T2, Augment> *n, Node<T1, T2, Augment> * const *r) : node(n), root(r) {}
+
+	reference operator*() const { return *node; }
+	pointer operator->() const { return node; }
+	Node<T1, T2, Augment> *getNode() const { return node; }
+
+	SplayIterator &operator++() {
+		node = node->getNext();
+		return *this;
+	}
+	SplayIterator &operator--() {
+		if (node != NULL)
+			node = node->getPrev();
+		else {	// from end() to the right most node
+			node = *root;
+			while (node->getRgt() != NULL)
+				node = node->getRgt();
+		}
+		return *this;
+	}
+	SplayIterator operator++(int) {
+		SplayIterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+	SplayIterator operator--(int) {
+		SplayIterator tmp = *this;
+		--*this;
+		return tmp;
+	}
+	bool operator==(const SplayIterator &b) const { return node == b.node; }
+	bool operator!=(const SplayIterator &b) const { return node != b.node; }
+};
+
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+class SplayTree;
+
+// Owns a node taken out of a Splay tree by extract(). The node keeps its ID and
+// record, and goes into another tree with no reallocation when the two
+// allocators are equal. A handle that still holds a node frees it.
+template<class T1, class T2, class Augment, class NodeAlloc>
+class SplayNodeHandle {
+
+	template<class, class, class, class, class> friend class SplayTree;
+	typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+	Node<T1, T2, Augment> *node;
+	NodeAlloc alloc;	// the allocator the node came from
+
+	SplayNodeHandle(Node<T1, T2, Augment> *nd, const NodeAlloc &a) : node(nd), alloc(a) {}
+	Node<T1, T2, Augment> *release() {
+		Node<T1, T2, Augment> *nd = node;
+		node = NULL;
+		return nd;
+	}
+
+public :
+	SplayNodeHandle() : node(NULL) {}
+	SplayNodeHandle(SplayNodeHandle &&b) : node(b.node), alloc(b.alloc) { b.node = NULL; }
+	SplayNodeHandle &operator=(SplayNodeHandle &&b) {
+		if (this != &b) {
+			reset();
+			alloc = b.alloc;
+			node = b.release();
+		}
+		return *this;
+	}
+	~SplayNodeHandle() { reset(); }
+
+	bool empty() const { return node == NULL; }
+	explicit operator bool() const { return node != NULL; }
+	const T1 &key() const { return node->getID(); }
+	T2 &mapped() const { return *node->getRcd(); }
+	void reset() {
+		if (node != NULL) {
+			NodeTraits::destroy(alloc, node);
+			NodeTraits::deallocate(alloc, node, 1);
+			node = NULL;
+		}
+	}
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////Splay tree/////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2 = NULLT>
-class SplayTree {
+template<class T1, class T2 = NULLT, class Compare = PtrCmp<T1>, class Alloc = std::allocator<T1>,
+	class Augment = NoAugment>
+class SplayTree : private Compare {	// empty compare policies take no space
+
+protected :	// SplaySequence builds on these to splay by position
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T1, T2, Augment> > NodeAlloc;
+	typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+	Node<T1, T2, Augment> *root;
+	NodeAlloc alloc;
+	struct SplayPolicy {	// how find restructures the tree
+		SplayMode mode = SplayFull;
+		double arg = 0;	// the depth threshold, or the probability to splay
+		unsigned long long seed = 0x9E3779B97F4A7C15ull;	// xorshift state for SplayRandom
+	} policy;
+
+#ifdef SPLAY_STATS
+	mutable SplayStats stats;	// mutable, as the const searches count too
+#endif
 
-private :
-	Node<T1, T2> *root;
-	int size;
-	int(*cmp)(const T1 &a, const T1 &b);
-
-	int calcSize(const Node<T1, T2> * const node) const;
-	int judgeCase(Node<T1, T2> *node, const T1 &id) const;
-	Node<T1, T2>* splay(Node<T1, T2> *N0, const T1 &id);
-	Node<T1, T2>* findRMN(Node<T1, T2>* const node) const;
-	Node<T1, T2>* findLMN(Node<T1, T2>* const node) const;
+	// probes tell splay which way to go from a node, like a compare function
+	struct KeyProbe {	// towards the node with ID "id"
+		const SplayTree<T1, T2, Compare, Alloc, Augment> *tree;
+		const T1 &id;
+		int operator()(const Node<T1, T2, Augment> *node) const { return tree->compare(id, node->getID()); }
+	};
+	struct MaxProbe {	// towards the right most node
+		int operator()(const Node<T1, T2, Augment> *) const { return 1; }
+	};
+	struct MinProbe {	// towards the left most node
+		int operator()(const Node<T1, T2, Augment> *) const { return -1; }
+	};
+	struct RankProbe {	// towards the node with "k" nodes before it
+		mutable int k;	// counted within the subtree of the node probed
+		int operator()(const Node<T1, T2, Augment> *node) const {
+			int lc = node->getLft() == NULL ? 0 : node->getLft()->getCount();
+			if (k < lc)
+				return -1;
+			if (k == lc)
+				return 0;
+			k -= lc + 1;
+			return 1;
+		}
+	};
+
+	int compare(const T1 &a, const T1 &b) const {
+#ifdef SPLAY_STATS
+		stats.compares++;
+#endif
+		return Compare::operator()(a, b);
+	}
+	void countOp(SplayStats::Op op, size_t n = 1) const {
+#ifdef SPLAY_STATS
+		stats.ops[op] += n;
+#else
+		(void)op;
+		(void)n;
+#endif
+	}
+	void countDepth(int depth) const {
+#ifdef SPLAY_STATS
+		int k = 0;
+		while (k < 31 && (2u << k) <= (unsigned)depth + 1)
+			k++;
+		stats.depths[k]++;
+#else
+		(void)depth;
+#endif
+	}
+	// The next ID of a sorted batch is not below the last one, so its search
+	// goes right of the root, or either way when the root is above the last ID.
+	void prefetchNext(int res) const {
+		SPLAY_PREFETCH(root->getRgt());
+		if (res < 0)
+			SPLAY_PREFETCH(root->getLft());
+	}
+	template<class... Args>
+	Node<T1, T2, Augment>* newNode(Args&&... args);
+	void linkRoot(Node<T1, T2, Augment> *node, int res);
+	static const T1 &keyOf(const T1 &id) { return id; }
+	template<class K, class R>
+	static const K &keyOf(const std::pair<K, R> &p) { return p.first; }
+	Node<T1, T2, Augment>* makeNode(const T1 &id) { return newNode(id); }
+	template<class K, class R>
+	Node<T1, T2, Augment>* makeNode(const std::pair<K, R> &p) { return newNode(p.first, p.second); }
+	template<class It>
+	Node<T1, T2, Augment>* buildBalanced(It &first, int n);
+	void freeNode(Node<T1, T2, Augment> *node);
+	void freeTree(Node<T1, T2, Augment> *node);
+	Node<T1, T2, Augment>* copyTree(const Node<T1, T2, Augment> *node);
+	template<class Probe>
+	int judgeCase(Node<T1, T2, Augment> *node, const Probe &probe, int c0, int *c1) const;
+	template<class Probe>
+	Node<T1, T2, Augment>* splayBy(Node<T1, T2, Augment> *N0, const Probe &probe, int *res = NULL);
+	Node<T1, T2, Augment>* splay(Node<T1, T2, Augment> *N0, const T1 &id, int *res = NULL);
+	Node<T1, T2, Augment>* descend(const T1 &id, int *res, int *depth) const;
+	void replaceSon(Node<T1, T2, Augment> *par, Node<T1, T2, Augment> *old, Node<T1, T2, Augment> *node);
+	template<class V>
+	std::vector<int> sortBatch(const std::vector<V> &items) const;
+	void splayUp(Node<T1, T2, Augment> *node, bool semi);
+	Node<T1, T2, Augment>* splayNext();
+	Node<T1, T2, Augment>* joinNodes(Node<T1, T2, Augment> *lft, Node<T1, T2, Augment> *rgt);
+	Node<T1, T2, Augment>* adopt(SplayTree<T1, T2, Compare, Alloc, Augment> &b);
+	Node<T1, T2, Augment>* findRMN(Node<T1, T2, Augment>* const node) const;
+	Node<T1, T2, Augment>* findLMN(Node<T1, T2, Augment>* const node) const;
 public :
+	typedef SplayIterator<T1, T2, Augment> iterator;
+	typedef SplayIterator<T1, T2, Augment> const_iterator;	// IDs are never changed through an iterator
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<iterator> const_reverse_iterator;
+	typedef typename Augment::value_type aggregate_type;
+	typedef SplayNodeHandle<T1, T2, Augment, NodeAlloc> node_type;
+
 	// constructors and destructor
 	SplayTree();
-	SplayTree(int(*compare)(const T1 &a, const T1 &b));
-	SplayTree(const Node<T1, T2> &head, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	SplayTree(const T1 &rootID, const T2 * const rootRcd = NULL, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	SplayTree(const T1 &rootID, const T2 &rootRcd, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	SplayTree(const SplayTree<T1, T2> &New);
+	SplayTree(const Compare &compare, const Alloc &a = Alloc());
+	SplayTree(const Node<T1, T2, Augment> &head, const Compare &compare = Compare());
+	SplayTree(const T1 &rootID, const T2 * const rootRcd = NULL, const Compare &compare = Compare());
+	SplayTree(const T1 &rootID, const T2 &rootRcd, const Compare &compare = Compare());
+	SplayTree(const SplayTree<T1, T2, Compare, Alloc, Augment> &New);
+	SplayTree(SplayTree<T1, T2, Compare, Alloc, Augment> &&Old);
+	template<class It, class = typename std::iterator_traits<It>::iterator_category>
+	SplayTree(It first, It last, const Compare &compare = Compare(), const Alloc &a = Alloc());
 	~SplayTree();
 
-	bool setCmp(int(*compare)(const T1 &a, const T1 &b));
+	SplayTree<T1, T2, Compare, Alloc, Augment> &operator=(const SplayTree<T1, T2, Compare, Alloc, Augment> &b);
+	SplayTree<T1, T2, Compare, Alloc, Augment> &operator=(SplayTree<T1, T2, Compare, Alloc, Augment> &&b);
+	void swap(SplayTree<T1, T2, Compare, Alloc, Augment> &b);
+
+	bool setCmp(const Compare &compare);
+	bool setSplayMode(SplayMode mode, double arg = 0);
+	SplayMode getSplayMode() const { return policy.mode; }
 	bool addRoot(const T1 &id, const T2 * const rcd = NULL);
 	bool addRoot(const T1 &id, const T2 &rcd);
-	bool addRoot(const Node<T1, T2> &New);
+	bool addRoot(const Node<T1, T2, Augment> &New);
 
 	bool Insert(const T1 &id);
+	bool Insert(T1 &&id);
+	template<class... Args>
+	std::pair<T2*, bool> emplace(Args&&... args);
+	template<class K, class... Args>
+	std::pair<T2*, bool> try_emplace(K &&id, Args&&... args);
+	// one splay each; the record and whether the node is new are returned
+	std::pair<T2*, bool> insert(const T1 &id, const T2 &rcd) { return try_emplace(id, rcd); }
+	std::pair<T2*, bool> insert(const T1 &id, T2 &&rcd) { return try_emplace(id, std::move(rcd)); }
+	template<class R>
+	std::pair<T2*, bool> insert_or_assign(const T1 &id, R &&rcd);
+	template<class Func>
+	std::pair<T2*, bool> upsert(const T1 &id, Func fn);
+	std::pair<T2*, bool> findOrInsert(const T1 &id) { return try_emplace(id); }
 	bool Delete(const T1 &id);
+	// moves a node out of the tree and back in, without freeing or allocating it
+	node_type extract(const T1 &id);
+	std::pair<T2*, bool> insert(node_type &&nh);
 	bool empty();
-
-	int getSize() const { return size; }
+	template<class It>
+	bool bulkLoad(It first, It last, bool check = false);
+	template<class It>
+	bool bulkLoadUnsorted(It first, It last);
+	SplayTree<T1, T2, Compare, Alloc, Augment> split(const T1 &id);
+	bool join(SplayTree<T1, T2, Compare, Alloc, Augment> &right);
+	bool merge(SplayTree<T1, T2, Compare, Alloc, Augment> &other);
+
+	int getSize() const { return root == NULL ? 0 : root->getCount(); }
 	int getHeight() const { return root->getHeight(); }
 	T2 *find(const T1 &id);
+	T2 *peek(const T1 &id) const;
+
+	// batches are served in sorted order, so that each splay starts next to the last one
+	int findBatch(const std::vector<T1> &keys, std::vector<T2*> &out);
+	template<class V>
+	int insertBatch(const std::vector<V> &items);
+	int deleteBatch(const std::vector<T1> &keys);
 	T1 rootID() const { return root->getID(); }
 	bool print() const;
+
+	// ordered search; these splay the boundary node to the root
+	iterator lower_bound(const T1 &id);
+	iterator upper_bound(const T1 &id);
+	std::pair<iterator, iterator> equal_range(const T1 &id);
+	template<class Func>
+	int forEachInRange(const T1 &lo, const T1 &hi, Func fn);
+	int countInRange(const T1 &lo, const T1 &hi);
+
+	// order statistics from the subtree counts; these splay as well
+	int rank(const T1 &id);
+	iterator select(int k);
+
+	// subtree aggregates of the augment policy
+	aggregate_type aggregate() const;
+	aggregate_type aggregate(const T1 &lo, const T1 &hi);
+	bool refresh();
+
+	// in-order iteration; none of these splays
+	iterator begin() const { return iterator(findLMN(root), &root); }
+	iterator end() const { return iterator(NULL, &root); }
+	reverse_iterator rbegin() const { return reverse_iterator(end()); }
+	reverse_iterator rend() const { return reverse_iterator(begin()); }
+#ifdef SPLAY_STATS
+	SplayStats getStats() const;
+	void resetStats() { stats = SplayStats(); }
+	unsigned long long getCmpCount() const { return stats.compares; }
+	void resetCmpCount() { stats.compares = 0; }
+	unsigned long long getLinkCount() const { return stats.links; }
+	void resetLinkCount() { stats.links = 0; }
+	unsigned long long getRotCount() const { return stats.rotations; }
+	void resetRotCount() { stats.rotations = 0; }
+#endif
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -550,77 +1220,70 @@ public :
 // DESCRIPTION: Constructor of SplayTree class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree() {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree() {
 	root = NULL;
-	size = 0;
-	cmp = dCmp;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: SplayTree
 // DESCRIPTION: Constructor of SplayTree class.
-//   ARGUMENTS: int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//   ARGUMENTS: const Compare &compare - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree(int(*compare)(const T1 &a, const T1 &b)) {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(const Compare &compare, const Alloc &a) : Compare(compare), alloc(a) {
 	root = NULL;
-	size = 0;
-	cmp = compare;
 }
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: SplayTree
 // DESCRIPTION: Constructor of SplayTree class.
-//   ARGUMENTS: const Node<T1, T2> &head - the root node of the Splay tree
-//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//   ARGUMENTS: const Node<T1, T2, Augment> &head - the root node of the Splay tree
+//				const Compare &compare = Compare() - the compare function
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree(const Node<T1, T2> &head, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(head.getID(), head.getRcd());
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(const Node<T1, T2, Augment> &head, const Compare &compare) : Compare(compare) {
+	root = newNode(head.getID(), head.getRcd());
 	if (root == NULL)
 		throw SplayERR("Out of space");
-	size = calcSize(root);
-	cmp = compare;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: SplayTree
 // DESCRIPTION: Constructor of SplayTree class.
 //   ARGUMENTS: const T1 &rootID - the ID of the root node
-//				const T2 * const rootRcd = dCmp - the initial root record
-//				int(*compare)(const T1 &a, const T1 &b) = NULL - the compare function
+//				const T2 * const rootRcd = NULL - the initial root record
+//				const Compare &compare = Compare() - the compare function
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree(const T1 &rootID, const T2 * const rootRcd, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(rootID, rootRcd);
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(const T1 &rootID, const T2 * const rootRcd, const Compare &compare) : Compare(compare) {
+	root = newNode(rootID, rootRcd);
 	if (root == NULL)
 		throw SplayERR("Out of space");
-	size = 1;
-	cmp = compare;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -628,44 +1291,36 @@ SplayTree<T1, T2>::SplayTree(const T1 &rootID, const T2 * const rootRcd, int(*co
 // DESCRIPTION: Constructor of SplayTree class.
 //   ARGUMENTS: const T1 &rootID - the ID of the root node
 //				const T2 &rootRcd - the initial root record
-//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//				const Compare &compare = Compare() - the compare function
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree(const T1 &rootID, const T2 &rootRcd, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(rootID, rootRcd);
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(const T1 &rootID, const T2 &rootRcd, const Compare &compare) : Compare(compare) {
+	root = newNode(rootID, rootRcd);
 	if (root == NULL)
 		throw SplayERR("Out of space");
-	size = 1;
-	cmp = compare;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: SplayTree
 // DESCRIPTION: Copy constructor of SplayTree class.
-//   ARGUMENTS: const SplayTree<T1, T2> &Old - the SplayTree that is to be copied
+//   ARGUMENTS: const SplayTree<T1, T2, Compare, Alloc, Augment> &Old - the SplayTree that is to be copied
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::SplayTree(const SplayTree<T1, T2> &Old) {
-	size = Old.size;
-	cmp = Old.cmp;
-	if (Old.root != NULL) {
-		root = new Node<T1, T2>;
-		if (root == NULL)
-			throw SplayERR("Out of space");
-		root->copy(Old.root);
-	}
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(const SplayTree<T1, T2, Compare, Alloc, Augment> &Old)
+	: Compare(Old), alloc(NodeTraits::select_on_container_copy_construction(Old.alloc)), policy(Old.policy) {
+	root = copyTree(Old.root);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -673,54 +1328,356 @@ SplayTree<T1, T2>::SplayTree(const SplayTree<T1, T2> &Old) {
 // DESCRIPTION: Destructor of SplayTree class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, Compare;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-SplayTree<T1, T2>::~SplayTree() {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::~SplayTree() {
 	//cout << "Destructor: ";
 	//if (root != NULL)
 	//	cout << root->getID();
 	//cout << endl;
-	delete root;
+	empty();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: calcSize
-// DESCRIPTION: To calculate the size of the tree with the root "node".
-//   ARGUMENTS: const Node<T1, T2> * const node - the root the of tree
+//        NAME: SplayTree
+// DESCRIPTION: Move constructor of SplayTree class. The nodes are taken over
+//				and "Old" is left empty.
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &&Old - the SplayTree that is to be moved
 // USES GLOBAL: none
-// MODIFIES GL: none
-//     RETURNS: int
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-int SplayTree<T1, T2>::calcSize(const Node<T1, T2> * const node) const {
-	if (node == NULL)
-		return 0;
-	else
-		return calcSize(node->getLft()) + calcSize(node->getRgt()) + 1;
+// MODIFIES GL: root, Compare, alloc;
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(SplayTree<T1, T2, Compare, Alloc, Augment> &&Old)
+	: Compare(Old), alloc(Old.alloc), policy(Old.policy) {	// a copy, so that "Old" can still allocate
+	root = Old.root;
+	Old.root = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: SplayTree
+// DESCRIPTION: Constructor of SplayTree class that bulk loads a range sorted
+//				in strictly increasing order of IDs (see bulkLoad).
+//   ARGUMENTS: It first, It last - the range of IDs or (ID, record) pairs
+//				const Compare &compare = Compare() - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes
+// USES GLOBAL: none
+// MODIFIES GL: root, Compare, alloc;
+//     RETURNS: none
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class It, class>
+SplayTree<T1, T2, Compare, Alloc, Augment>::SplayTree(It first, It last, const Compare &compare, const Alloc &a)
+	: Compare(compare), alloc(a) {
+	root = NULL;
+	bulkLoad(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: operator=
+// DESCRIPTION: To copy another Splay tree into this one.
+//   ARGUMENTS: const SplayTree<T1, T2, Compare, Alloc, Augment> &b - the tree that is to be copied
+// USES GLOBAL: none
+// MODIFIES GL: root, Compare
+//     RETURNS: SplayTree<T1, T2, Compare, Alloc, Augment>&
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment> &SplayTree<T1, T2, Compare, Alloc, Augment>::operator=(const SplayTree<T1, T2, Compare, Alloc, Augment> &b) {
+	if (&b == this)
+		return *this;
+	empty();	// first, as it may drop the whole pool
+	Compare::operator=(b);
+	policy = b.policy;
+	if (NodeTraits::propagate_on_container_copy_assignment::value)
+		alloc = b.alloc;
+	root = copyTree(b.root);
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: operator=
+// DESCRIPTION: To move another Splay tree into this one. The nodes are taken
+//				over when the allocators allow it, or copied otherwise; "b" is
+//				left empty.
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &&b - the tree that is to be moved
+// USES GLOBAL: none
+// MODIFIES GL: root, Compare, alloc
+//     RETURNS: SplayTree<T1, T2, Compare, Alloc, Augment>&
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment> &SplayTree<T1, T2, Compare, Alloc, Augment>::operator=(SplayTree<T1, T2, Compare, Alloc, Augment> &&b) {
+	if (&b == this)
+		return *this;
+	empty();
+	Compare::operator=(b);
+	policy = b.policy;
+	if (NodeTraits::propagate_on_container_move_assignment::value)
+		alloc = b.alloc;
+	if (alloc == b.alloc) {
+		root = b.root;
+		b.root = NULL;
+	}
+	else {
+		root = copyTree(b.root);
+		b.empty();
+	}
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: swap
+// DESCRIPTION: To swap the contents of two Splay trees in O(1).
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &b - the other tree
+// USES GLOBAL: none
+// MODIFIES GL: root, Compare, alloc
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::swap(SplayTree<T1, T2, Compare, Alloc, Augment> &b) {
+	using std::swap;
+	swap(static_cast<Compare&>(*this), static_cast<Compare&>(b));
+	if (NodeTraits::propagate_on_container_swap::value)
+		swap(alloc, b.alloc);
+	swap(root, b.root);
+	swap(policy, b.policy);
+}
+
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void swap(SplayTree<T1, T2, Compare, Alloc, Augment> &a, SplayTree<T1, T2, Compare, Alloc, Augment> &b) {
+	a.swap(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: newNode
+// DESCRIPTION: To allocate and construct a node with the tree's allocator.
+//   ARGUMENTS: Args&&... args - the arguments for the constructor of Node
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: Node<T1, T2, Augment>*
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class... Args>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::newNode(Args&&... args) {
+	Node<T1, T2, Augment> *node = NodeTraits::allocate(alloc, 1);
+	try {
+		NodeTraits::construct(alloc, node, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		NodeTraits::deallocate(alloc, node, 1);
+		throw;
+	}
+#ifdef SPLAY_STATS
+	stats.allocs++;
+#endif
+	return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: freeNode
+// DESCRIPTION: To destruct and deallocate a single node. Its sons are cut off
+//				first, so they are left alone.
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the node that is to be freed
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::freeNode(Node<T1, T2, Augment> *node) {
+	node->AddLft((Node<T1, T2, Augment>*)NULL);
+	node->AddRgt((Node<T1, T2, Augment>*)NULL);
+	NodeTraits::destroy(alloc, node);
+	NodeTraits::deallocate(alloc, node, 1);
+#ifdef SPLAY_STATS
+	stats.frees++;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: freeTree
+// DESCRIPTION: To free all the nodes of a subtree. Left sons are rotated up
+//				until the subtree becomes a right chain, which is freed node by
+//				node, so no stack is needed however deep the subtree is.
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the root of the subtree
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::freeTree(Node<T1, T2, Augment> *node) {
+	Node<T1, T2, Augment> *tmp;
+	while (node != NULL) {
+		tmp = node->getLft();
+		if (tmp != NULL) {	// rotate right
+			node->AddLft(tmp->getRgt());
+			tmp->AddRgt(node);
+		}
+		else {
+			tmp = node->getRgt();
+			freeNode(node);
+		}
+		node = tmp;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: copyTree
+// DESCRIPTION: To copy a subtree with the tree's allocator. The subtree is
+//				walked in pre-order with a stack of pending right sons only.
+//   ARGUMENTS: const Node<T1, T2, Augment> *node - the root of the subtree
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: Node<T1, T2, Augment>*
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::copyTree(const Node<T1, T2, Augment> *node) {
+	std::vector<std::pair<Node<T1, T2, Augment>*, const Node<T1, T2, Augment>*> > stk;	// right sons still to copy
+	Node<T1, T2, Augment> *New, *dst;
+	const Node<T1, T2, Augment> *src = node;
+	if (node == NULL)
+		return NULL;
+	New = dst = newNode(node->getID(), node->getRcd());
+	try {
+		while (src != NULL) {
+			if (src->getLft() != NULL)
+				dst->AddLft(newNode(src->getLft()->getID(), src->getLft()->getRcd()));
+			if (src->getRgt() != NULL)
+				dst->AddRgt(newNode(src->getRgt()->getID(), src->getRgt()->getRcd()));
+			dst->ModifyHeight(src->getHeight());	// the sons are not done yet
+			dst->ModifyCount(src->getCount());
+			dst->ModifyAgg(src->getAgg());
+
+			if (src->getLft() != NULL) {
+				if (src->getRgt() != NULL)
+					stk.push_back(std::make_pair(dst->getRgt(), src->getRgt()));
+				dst = dst->getLft();
+				src = src->getLft();
+			}
+			else {
+				dst = dst->getRgt();
+				src = src->getRgt();
+			}
+			if (src == NULL && !stk.empty()) {
+				dst = stk.back().first;
+				src = stk.back().second;
+				stk.pop_back();
+			}
+		}
+	}
+	catch (...) {
+		freeTree(New);
+		throw;
+	}
+	return New;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: linkRoot
+// DESCRIPTION: To make a new node the root, with the old root and its far
+//				subtree on one side and the old root's near son on the other.
+//				The tree must have been splayed at the node's ID already.
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the new node
+//				int res - the compare result of the new ID and the root's ID
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::linkRoot(Node<T1, T2, Augment> *node, int res) {
+	if (root != NULL) {
+		if (res < 0) {
+			node->AddLft(root->getLft());
+			root->AddLft((Node<T1, T2, Augment>*)NULL);
+			node->AddRgt(root);
+		}
+		else {
+			node->AddRgt(root->getRgt());
+			root->AddRgt((Node<T1, T2, Augment>*)NULL);
+			node->AddLft(root);
+		}
+	}
+	node->ModifyPar((Node<T1, T2, Augment>*)NULL);
+	root = node;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: setCmp
-// DESCRIPTION: To assign the compare function to the member function pointer.
-//   ARGUMENTS: int(*compare)(const T1 &a, const T1 &b) - the compare function
+// DESCRIPTION: To assign the compare function. With the default PtrCmp policy
+//				a plain int(*)(const T1 &a, const T1 &b) can be passed.
+//   ARGUMENTS: const Compare &compare - the compare function
+//				const Alloc &a = Alloc() - the allocator of the nodes
 // USES GLOBAL: none
-// MODIFIES GL: cmp
+// MODIFIES GL: Compare
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::setCmp(const Compare &compare) {
+	Compare::operator=(compare);
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::setCmp(int(*compare)(const T1 &a, const T1 &b)) {
-	cmp = compare;
+//        NAME: setSplayMode
+// DESCRIPTION: To choose how find restructures the tree. A full splay writes
+//				links all along the path even for a node near the root; the
+//				other modes write less on hot reads, at the price of a weaker
+//				move-to-root. Only find is affected, and not on a tree with
+//				an Augment policy, whose find always splays fully.
+//   ARGUMENTS: SplayMode mode - SplayFull, SplaySemi, SplayDepth or SplayRandom
+//				double arg = 0 - for SplayDepth, nodes at this depth or less
+//				are not splayed; for SplayRandom, the probability to splay
+// USES GLOBAL: none
+// MODIFIES GL: policy
+//     RETURNS: bool - false if "arg" is out of range
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::setSplayMode(SplayMode mode, double arg) {
+	if (mode == SplayDepth && arg < 0)
+		return false;
+	if (mode == SplayRandom && (arg < 0 || arg > 1))
+		return false;
+	policy.mode = mode;
+	policy.arg = arg;
 	return true;
 }
 
@@ -730,23 +1687,22 @@ bool SplayTree<T1, T2>::setCmp(int(*compare)(const T1 &a, const T1 &b)) {
 //   ARGUMENTS: const T1 &id - the id of the root node
 //				const T2 * const rcd - the record of the root node with default value NULL
 // USES GLOBAL: none
-// MODIFIES GL: root, size
+// MODIFIES GL: root
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::addRoot(const T1 &id, const T2 * const rcd) {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::addRoot(const T1 &id, const T2 * const rcd) {
 	if (root != NULL) {
 		throw SplayERR("root already exists");
 	}
-	root = new Node<T1, T2>(id, rcd);
+	root = newNode(id, rcd);
 	if (root == NULL) {
 		throw SplayERR("Out of space");
 		return false;
 	}
-	size = calcSize(root);
 	return true;
 }
 
@@ -756,48 +1712,46 @@ bool SplayTree<T1, T2>::addRoot(const T1 &id, const T2 * const rcd) {
 //   ARGUMENTS: const T1 &id - the id of the root node
 //				const T2 &rcd - the record of the root node
 // USES GLOBAL: none
-// MODIFIES GL: root, size
+// MODIFIES GL: root
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::addRoot(const T1 &id, const T2 &rcd) {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::addRoot(const T1 &id, const T2 &rcd) {
 	if (root != NULL) {
 		throw SplayERR("root already exists");
 	}
-	root = new Node<T1, T2>(id, rcd);
+	root = newNode(id, rcd);
 	if (root == NULL) {
 		throw SplayERR("Out of space");
 		return false;
 	}
-	size = calcSize(root);
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: addRoot
 // DESCRIPTION: To add a root for the Splay tree.
-//   ARGUMENTS: const Node<T1, T2> &New - the copy of the root node
+//   ARGUMENTS: const Node<T1, T2, Augment> &New - the copy of the root node
 // USES GLOBAL: none
-// MODIFIES GL: root, size
+// MODIFIES GL: root
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::addRoot(const Node<T1, T2> &New) {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::addRoot(const Node<T1, T2, Augment> &New) {
 	if (root != NULL) {
 		throw SplayERR("root already exists");
 	}
-	root = new Node<T1, T2>(New);
+	root = copyTree(&New);
 	if (root == NULL) {
 		throw SplayERR("Out of space");
 		return false;
 	}
-	size = calcSize(root);
 	return true;
 }
 
@@ -806,94 +1760,209 @@ bool SplayTree<T1, T2>::addRoot(const Node<T1, T2> &New) {
 // DESCRIPTION: To delete all the nodes in the Splay tree.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size
+// MODIFIES GL: root
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::empty() {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::empty() {
 	if (root == NULL)
 		return true;
-	delete root;
+
+#ifdef SPLAY_STATS
+	int n = root->getCount();
+#endif
+
+	// nothing to destruct in any node: the arena can be dropped as a whole
+	if (!(std::is_trivially_destructible<T1>::value && std::is_trivially_destructible<T2>::value
+		&& std::is_trivially_destructible<typename Augment::value_type>::value)
+		|| !AllocRelease<NodeAlloc>::release(alloc))
+		freeTree(root);
+#ifdef SPLAY_STATS
+	else
+		stats.frees += n;
+#endif
 	root = NULL;
-	size = 0;
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: buildBalanced
+// DESCRIPTION: To build a perfectly balanced subtree from the next n elements
+//				of a sorted range, in order, so every element is read once.
+//   ARGUMENTS: It &first - the next element; moved past the n elements used
+//				int n - the number of nodes of the subtree
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: Node<T1, T2, Augment>*
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class It>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::buildBalanced(It &first, int n) {
+	Node<T1, T2, Augment> *lft, *node;
+	if (n <= 0)
+		return NULL;
+	lft = buildBalanced(first, (n - 1) / 2);
+	try {
+		node = makeNode(*first);
+		++first;
+	}
+	catch (...) {
+		freeTree(lft);
+		throw;
+	}
+	node->AddLft(lft);
+	try {
+		node->AddRgt(buildBalanced(first, n - 1 - (n - 1) / 2));
+	}
+	catch (...) {
+		freeTree(node);
+		throw;
+	}
+	return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: bulkLoad
+// DESCRIPTION: To replace the contents of the Splay tree with a range sorted
+//				in strictly increasing order of IDs. The tree is built
+//				perfectly balanced in O(n), without any compare unless "check"
+//				is set. Single pass input iterators are copied first.
+//   ARGUMENTS: It first, It last - the range of IDs or (ID, record) pairs
+//				bool check = false - to check the order first; SplayERR is
+//				thrown, with the tree untouched, if it is wrong
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class It>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::bulkLoad(It first, It last, bool check) {
+	typedef typename std::iterator_traits<It>::iterator_category Category;
+	typedef typename std::iterator_traits<It>::value_type Value;
+	if (!std::is_base_of<std::forward_iterator_tag, Category>::value) {
+		std::vector<Value> tmp(first, last);
+		return bulkLoad(tmp.begin(), tmp.end(), check);
+	}
+	countOp(SplayStats::OpReshape);
+
+	long long n = std::distance(first, last);
+	if (n > 0x7fffffff)
+		throw SplayERR("Too many nodes");
+	if (check) {
+		It prev = first, cur = first;
+		if (cur != last)
+			for (++cur; cur != last; ++prev, ++cur)
+				if (compare(keyOf(*prev), keyOf(*cur)) >= 0)
+					throw SplayERR("Input not sorted");
+	}
+
+	empty();
+	root = buildBalanced(first, (int)n);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: bulkLoadUnsorted
+// DESCRIPTION: To replace the contents of the Splay tree with a range in any
+//				order. The range is copied and sorted (in parallel when
+//				SPLAY_PARALLEL_SORT is defined); for a repeated ID the first
+//				element is kept. Then it is loaded by bulkLoad.
+//   ARGUMENTS: It first, It last - the range of IDs or (ID, record) pairs
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class It>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::bulkLoadUnsorted(It first, It last) {
+	typedef typename std::iterator_traits<It>::value_type Value;
+	std::vector<Value> tmp(first, last);
+	const SplayTree<T1, T2, Compare, Alloc, Augment> *tree = this;
+	auto less = [tree](const Value &a, const Value &b) {
+		return tree->compare(keyOf(a), keyOf(b)) < 0;
+	};
+	auto same = [tree](const Value &a, const Value &b) {
+		return tree->compare(keyOf(a), keyOf(b)) == 0;
+	};
+#ifdef SPLAY_PARALLEL_SORT
+	std::stable_sort(std::execution::par, tmp.begin(), tmp.end(), less);
+#else
+	std::stable_sort(tmp.begin(), tmp.end(), less);
+#endif
+	tmp.erase(std::unique(tmp.begin(), tmp.end(), same), tmp.end());
+	return bulkLoad(tmp.begin(), tmp.end());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: judgeCase
 // DESCRIPTION: To decide the rotation type for splay function.
-//   ARGUMENTS: Node<T1, T2> *node - the root of the subtree that needs rotation
-//				const T1 &id - the id that is to find
+//				The probe is called on the son of "node" only, and at most once.
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the root of the subtree that needs rotation
+//				const Probe &probe - tells the way to go from a node
+//				int c0 - the result of the probe on "node"
+//				int *c1 - returns the result of the probe on the son, if called
 // USES GLOBAL: none
 // MODIFIES GL: none
 //     RETURNS: int
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-14
-//							KC 2015-02-14
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-int SplayTree<T1, T2>::judgeCase(Node<T1, T2> *node, const T1 &id) const {
-	
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class Probe>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::judgeCase(Node<T1, T2, Augment> *node, const Probe &probe, int c0, int *c1) const {
+
 	// no adjust needed
-	if (cmp(id, node->getID()) == 0)
+	if (c0 == 0)
 		return 0;
-	if ((cmp(id, node->getID()) < 0) && (node->getLft() == NULL))
-		return 0;
-	if ((cmp(id, node->getID()) > 0) && (node->getRgt() == NULL))
-		return 0;
-	
-	// zig
-	if ((cmp(id, node->getID()) < 0) && (cmp(id, node->getLft()->getID()) == 0))
-		return 1;
-	if ((cmp(id, node->getID()) < 0) && (cmp(id, node->getLft()->getID()) < 0) && (node->getLft()->getLft() == NULL))
-		return 1;
-	if ((cmp(id, node->getID()) < 0) && (cmp(id, node->getLft()->getID()) > 0) && (node->getLft()->getRgt() == NULL))
-		return 1;
-	
-	// zag
-	if ((cmp(id, node->getID()) > 0) && (cmp(id, node->getRgt()->getID()) == 0))
-		return 2;
-	if ((cmp(id, node->getID()) > 0) && (cmp(id, node->getRgt()->getID()) < 0) && (node->getRgt()->getLft() == NULL))
-		return 2;
-	if ((cmp(id, node->getID()) > 0) && (cmp(id, node->getRgt()->getID()) > 0) && (node->getRgt()->getRgt() == NULL))
-		return 2;
-
-	// zig-zig
-	if ((cmp(id, node->getID()) < 0) && (cmp(id, node->getLft()->getID()) < 0))
-		return 3;
-	
-	// zag-zag
-	if ((cmp(id, node->getID()) > 0) && (cmp(id, node->getRgt()->getID()) > 0))
-		return 4;
 
-	// zig-zag
-	if ((cmp(id, node->getID()) < 0) && (cmp(id, node->getLft()->getID()) > 0))
-		return 5;
-	
-	// zag-zig
-	if ((cmp(id, node->getID()) > 0) && (cmp(id, node->getRgt()->getID()) < 0))
-		return 6;
+	if (c0 < 0) {
+		if (node->getLft() == NULL)
+			return 0;
+		*c1 = probe(node->getLft());
+		if (*c1 == 0)	// zig
+			return 1;
+		if (*c1 < 0)	// zig or zig-zig
+			return node->getLft()->getLft() == NULL ? 1 : 3;
+		return node->getLft()->getRgt() == NULL ? 1 : 5;	// zig or zig-zag
+	}
 
-	return -1;
+	if (node->getRgt() == NULL)
+		return 0;
+	*c1 = probe(node->getRgt());
+	if (*c1 == 0)	// zag
+		return 2;
+	if (*c1 > 0)	// zag or zag-zag
+		return node->getRgt()->getRgt() == NULL ? 2 : 4;
+	return node->getRgt()->getLft() == NULL ? 2 : 6;	// zag or zag-zig
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: findRMN
 // DESCRIPTION: To find the right most node in the subtree.
-//   ARGUMENTS: Node<T1, T2> *node - the root of the subtree
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the root of the subtree
 // USES GLOBAL: none
 // MODIFIES GL: none
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Augment>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-14
-//							KC 2015-02-14
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* SplayTree<T1, T2>::findRMN(Node<T1, T2>* const node) const {
-	Node<T1, T2>* RMN = &(*node);
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::findRMN(Node<T1, T2, Augment>* const node) const {
+	Node<T1, T2, Augment>* RMN = node;
 	if (RMN == NULL)
 		return NULL;
 	while (RMN->getRgt() != NULL)
@@ -904,17 +1973,17 @@ Node<T1, T2>* SplayTree<T1, T2>::findRMN(Node<T1, T2>* const node) const {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: findLMN
 // DESCRIPTION: To find the left most node in the subtree.
-//   ARGUMENTS: Node<T1, T2> *node - the root of the subtree
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the root of the subtree
 // USES GLOBAL: none
 // MODIFIES GL: none
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Augment>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-14
-//							KC 2015-02-14
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* SplayTree<T1, T2>::findLMN(Node<T1, T2>* const node) const {
-	Node<T1, T2>* LMN = &(*node);
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::findLMN(Node<T1, T2, Augment>* const node) const {
+	Node<T1, T2, Augment>* LMN = node;
 	if (LMN == NULL)
 		return NULL;
 	while (LMN->getLft() != NULL)
@@ -923,55 +1992,91 @@ Node<T1, T2>* SplayTree<T1, T2>::findLMN(Node<T1, T2>* const node) const {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: balance
-// DESCRIPTION: To balance a subtree whose root is "node".
-//   ARGUMENTS: Node<T1, T2> *node - the root of the sub tree
+//        NAME: splay
+// DESCRIPTION: To splay the node with ID "id" (or the last node on its search
+//				path) to the root of the subtree whose root is "N0".
+//   ARGUMENTS: Node<T1, T2, Augment> *N0 - the root of the sub tree
+//				const T1 &id - the id that is to find
+//				int *res - returns the compare result of "id" and the new root
 // USES GLOBAL: none
-// MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>*
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::splay(Node<T1, T2, Augment> *N0, const T1 &id, int *res) {
+	KeyProbe probe = { this, id };
+	return splayBy(N0, probe, res);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: splayBy
+// DESCRIPTION: To splay the node the probe leads to (or the last node on its
+//				path) to the root of the subtree whose root is "N0".
+//				The probe is called at most once for every node on the path.
+//				The left and right assembly trees are kept by their tail nodes
+//				only. Every tail is chained to the previous one through the
+//				link that is still free (Rgt for the left tree, Lft for the
+//				right tree), so a step costs O(1) and the reassembly unwinds
+//				the chains bottom-up, which keeps the heights exact.
+//   ARGUMENTS: Node<T1, T2, Augment> *N0 - the root of the sub tree
+//				const Probe &probe - tells the way to go from a node
+//				int *res - returns the result of the probe on the new root
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-12
-//							KC 2015-02-12
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* SplayTree<T1, T2>::splay(Node<T1, T2> *N0, const T1 &id) {
-	Node<T1, T2> *L = NULL;
-	Node<T1, T2> *R = NULL;
-	Node<T1, T2> *N1 = NULL;
-	Node<T1, T2> *N2 = NULL;
-	Node<T1, T2> *RMN = NULL;
-	Node<T1, T2> *LMN = NULL;
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class Probe>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::splayBy(Node<T1, T2, Augment> *N0, const Probe &probe, int *res) {
+	Node<T1, T2, Augment> *LT = NULL;	// tail of the left tree
+	Node<T1, T2, Augment> *RT = NULL;	// tail of the right tree
+	Node<T1, T2, Augment> *N1 = NULL;
+	Node<T1, T2, Augment> *N2 = NULL;
 	int Case = -1;
+	int c0, c1 = 0;	// results of the probe on N0 and its son
+#ifdef SPLAY_STATS
+	int depth = 0;
+#endif
 	if (N0 == NULL)
 		return NULL;
-	while ((N0 != NULL) && (cmp(id, N0->getID()))) {
-		Case = judgeCase(N0, id);
+	c0 = probe(N0);
+	while (c0 != 0) {
+		Case = judgeCase(N0, probe, c0, &c1);
+#ifdef SPLAY_STATS
+		static const int links[] = { 0, 1, 1, 3, 3, 2, 2 };	// AddLft/AddRgt calls of each case
+		if (Case >= 0 && Case <= 6) {
+			stats.cases[Case]++;
+			stats.links += links[Case];
+			stats.rotations += Case == 0 ? 0 : Case <= 2 ? 1 : 2;
+			depth += Case == 0 ? 0 : Case <= 2 ? 1 : 2;
+		}
+#endif
 		switch(Case) {
 		case 0: // found
 			goto Break_While_Loop;
 
 		case 1: // zig
 			N1 = N0->getLft();
-			N0->AddLft((Node<T1, T2>*)NULL);
-			LMN = findLMN(R);
-			if (LMN == NULL)
-				R = N0;
-			else
-				LMN->AddLft(N0);
+			N0->AddLft(RT);
+			RT = N0;
 			N0 = N1;
 			N1 = NULL;
+			c0 = c1;
 			break;
 
 		case 2: // zag
 			N1 = N0->getRgt();
-			N0->AddRgt((Node<T1, T2>*)NULL);
-			RMN = findRMN(L);
-			if (RMN == NULL)
-				L = N0;
-			else
-				RMN->AddRgt(N0);
+			N0->AddRgt(LT);
+			LT = N0;
 			N0 = N1;
 			N1 = NULL;
+			c0 = c1;
 			break;
 
 		case 3: // zig-zig
@@ -979,14 +2084,11 @@ Node<T1, T2>* SplayTree<T1, T2>::splay(Node<T1, T2> *N0, const T1 &id) {
 			N2 = N1->getLft();
 			N0->AddLft(N1->getRgt());
 			N1->AddRgt(N0);
-			N1->AddLft((Node<T1, T2>*)NULL);
-			LMN = findLMN(R);
-			if (LMN == NULL)
-				R = N1;
-			else
-				LMN->AddLft(N1);
+			N1->AddLft(RT);
+			RT = N1;
 			N0 = N2;
 			N1 = N2 = NULL;
+			c0 = probe(N0);
 			break;
 
 		case 4: // zag-zag
@@ -994,52 +2096,35 @@ Node<T1, T2>* SplayTree<T1, T2>::splay(Node<T1, T2> *N0, const T1 &id) {
 			N2 = N1->getRgt();
 			N0->AddRgt(N1->getLft());
 			N1->AddLft(N0);
-			N1->AddRgt((Node<T1, T2>*)NULL);
-			RMN = findRMN(L);
-			if (RMN == NULL)
-				L = N1;
-			else
-				RMN->AddRgt(N1);
+			N1->AddRgt(LT);
+			LT = N1;
 			N0 = N2;
 			N1 = N2 = NULL;
+			c0 = probe(N0);
 			break;
 
 		case 5: // zig-zag
 			N1 = N0->getLft();
 			N2 = N1->getRgt();
-			N0->AddLft((Node<T1, T2>*)NULL);
-			N1->AddRgt((Node<T1, T2>*)NULL);
-			LMN = findLMN(R);
-			RMN = findRMN(L);
-			if (LMN == NULL)
-				R = N0;
-			else
-				LMN->AddLft(N0);
-			if (RMN == NULL)
-				L = N1;
-			else
-				RMN->AddRgt(N1);
+			N0->AddLft(RT);
+			RT = N0;
+			N1->AddRgt(LT);
+			LT = N1;
 			N0 = N2;
 			N1 = N2 = NULL;
+			c0 = probe(N0);
 			break;
 
 		case 6: // zag-zig
 			N1 = N0->getRgt();
 			N2 = N1->getLft();
-			N0->AddRgt((Node<T1, T2>*)NULL);
-			N1->AddLft((Node<T1, T2>*)NULL);
-			LMN = findLMN(R);
-			RMN = findRMN(L);
-			if (LMN == NULL)
-				R = N1;
-			else
-				LMN->AddLft(N1);
-			if (RMN == NULL)
-				L = N0;
-			else
-				RMN->AddRgt(N0);
+			N0->AddRgt(LT);
+			LT = N0;
+			N1->AddLft(RT);
+			RT = N1;
 			N0 = N2;
 			N1 = N2 = NULL;
+			c0 = probe(N0);
 			break;
 
 		default:
@@ -1049,91 +2134,860 @@ Node<T1, T2>* SplayTree<T1, T2>::splay(Node<T1, T2> *N0, const T1 &id) {
 	}
 
 Break_While_Loop : // reassembly
-	LMN = findLMN(R);
-	RMN = findRMN(L);
-	if (LMN == NULL)
-		R = N0->getRgt();
-	else
-		LMN->AddLft(N0->getRgt());
-	if (RMN == NULL)
-		L = N0->getLft();
-	else
-		RMN->AddRgt(N0->getLft());
-	N0->AddLft(L);
-	N0->AddRgt(R);
+#ifdef SPLAY_STATS
+	countDepth(depth);
+#endif
+	if (LT == NULL && RT == NULL) {	// N0 stays the root: nothing to write back
+		if (N0->getPar() != NULL)
+			N0->ModifyPar((Node<T1, T2, Augment>*)NULL);
+		if (res != NULL)
+			*res = c0;
+		return N0;
+	}
+	N1 = N0->getLft();
+	while (LT != NULL) {	// from the tail of the left tree up to its root
+		N2 = LT->getRgt();
+		LT->AddRgt(N1);
+		N1 = LT;
+		LT = N2;
+#ifdef SPLAY_STATS
+		stats.links++;
+#endif
+	}
+	N0->AddLft(N1);
+	N1 = N0->getRgt();
+	while (RT != NULL) {	// from the tail of the right tree up to its root
+		N2 = RT->getLft();
+		RT->AddLft(N1);
+		N1 = RT;
+		RT = N2;
+#ifdef SPLAY_STATS
+		stats.links++;
+#endif
+	}
+	N0->AddRgt(N1);
+#ifdef SPLAY_STATS
+	stats.links += 2;
+#endif
+	N0->ModifyPar((Node<T1, T2, Augment>*)NULL);
+	if (res != NULL)
+		*res = c0;
 	return N0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: descend
+// DESCRIPTION: To search for "id" from the root without changing the tree.
+//   ARGUMENTS: const T1 &id - the ID to search for
+//				int *res - returns the compare result of "id" and the last node
+//				int *depth - returns the depth of the last node
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>* - the node of "id", or the last node
+//				on its search path
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::descend(const T1 &id, int *res, int *depth) const {
+	Node<T1, T2, Augment> *node = root, *next;
+	*depth = 0;
+	while (true) {
+		*res = compare(id, node->getID());
+		next = *res < 0 ? node->getLft() : node->getRgt();
+		if (*res == 0 || next == NULL) {
+			countDepth(*depth);
+			return node;
+		}
+		node = next;
+		++*depth;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: replaceSon
+// DESCRIPTION: To put "node" where "old" was under "par", or at the root.
+//   ARGUMENTS: Node<T1, T2, Augment> *par - the parent, NULL for the root
+//				Node<T1, T2, Augment> *old - the son that is replaced
+//				Node<T1, T2, Augment> *node - the new son
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::replaceSon(Node<T1, T2, Augment> *par, Node<T1, T2, Augment> *old,
+	Node<T1, T2, Augment> *node) {
+	if (par == NULL) {
+		node->ModifyPar((Node<T1, T2, Augment>*)NULL);
+		root = node;
+		return;
+	}
+	if (par->getLft() == old)
+		par->AddLft(node);
+	else
+		par->AddRgt(node);
+#ifdef SPLAY_STATS
+	stats.links++;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: splayUp
+// DESCRIPTION: To splay "node" bottom-up through the parent links. A full
+//				splay brings it to the root. A semi-splay rotates only the
+//				parent at a zig-zig and goes on from there, and leaves out the
+//				last zig, so that fewer links are written and a node next to
+//				the root is left alone. Each step links its nodes bottom-up
+//				and the node above them once, so the heights, counts and
+//				aggregates stay exact.
+//   ARGUMENTS: Node<T1, T2, Augment> *node - the node to splay
+//				bool semi - whether to semi-splay
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: void
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+void SplayTree<T1, T2, Compare, Alloc, Augment>::splayUp(Node<T1, T2, Augment> *node, bool semi) {
+	Node<T1, T2, Augment> *par, *grand, *top;
+	bool lft, line;	// whether "node" is a left son, and whether its parent is a son on the same side
+	while ((par = node->getPar()) != NULL) {
+		grand = par->getPar();
+		lft = par->getLft() == node;
+		if (grand == NULL) {	// zig
+			if (semi)
+				return;
+			if (lft) {
+				par->AddLft(node->getRgt());
+				node->AddRgt(par);
+			}
+			else {
+				par->AddRgt(node->getLft());
+				node->AddLft(par);
+			}
+#ifdef SPLAY_STATS
+			stats.cases[lft ? 1 : 2]++;
+			stats.links += 2;
+			stats.rotations++;
+#endif
+			replaceSon(NULL, par, node);
+			return;
+		}
+		top = grand->getPar();
+		line = (grand->getLft() == par) == lft;
+		if (line && semi) {	// zig-zig, the parent only
+			if (lft) {
+				grand->AddLft(par->getRgt());
+				par->AddRgt(grand);
+			}
+			else {
+				grand->AddRgt(par->getLft());
+				par->AddLft(grand);
+			}
+#ifdef SPLAY_STATS
+			stats.cases[lft ? 3 : 4]++;
+			stats.links += 2;
+			stats.rotations++;
+#endif
+			replaceSon(top, grand, par);
+			node = par;
+			continue;
+		}
+		if (line) {	// zig-zig
+			if (lft) {
+				grand->AddLft(par->getRgt());
+				par->AddLft(node->getRgt());
+				par->AddRgt(grand);
+				node->AddRgt(par);
+			}
+			else {
+				grand->AddRgt(par->getLft());
+				par->AddRgt(node->getLft());
+				par->AddLft(grand);
+				node->AddLft(par);
+			}
+		}
+		else if (lft) {	// zag-zig
+			par->AddLft(node->getRgt());
+			grand->AddRgt(node->getLft());
+			node->AddRgt(par);
+			node->AddLft(grand);
+		}
+		else {	// zig-zag
+			par->AddRgt(node->getLft());
+			grand->AddLft(node->getRgt());
+			node->AddLft(par);
+			node->AddRgt(grand);
+		}
+#ifdef SPLAY_STATS
+		stats.cases[line ? (lft ? 3 : 4) : (lft ? 6 : 5)]++;
+		stats.links += 4;
+		stats.rotations += 2;
+#endif
+		replaceSon(top, grand, node);
+	}
+}
+
+#ifdef SPLAY_STATS
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getStats
+// DESCRIPTION: To take a snapshot of the counters, for a metrics export. The
+//				greatest depth is the height of the tree, which is exact at
+//				any time.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: SplayStats
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayStats SplayTree<T1, T2, Compare, Alloc, Augment>::getStats() const {
+	SplayStats snap = stats;
+	snap.maxDepth = root == NULL ? 0 : root->getHeight();
+	return snap;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: find
-// DESCRIPTION: To find a node of a certain ID in Splay tree.
+// DESCRIPTION: To find a node of a certain ID in Splay tree. The tree is
+//				restructured as the splay mode says (see setSplayMode), except
+//				with an Augment policy: then the node is always splayed to the
+//				root, so that refresh() finds it there.
 //   ARGUMENTS: const T1 &id - the ID of the node that we want to find
 // USES GLOBAL: none
-// MODIFIES GL: none
+// MODIFIES GL: root, policy
 //     RETURNS: T2*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-T2 *SplayTree<T1, T2>::find(const T1 &id) {
-	root = splay(root, id);
-	if (cmp(id, root->getID()) != 0)
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+T2 *SplayTree<T1, T2, Compare, Alloc, Augment>::find(const T1 &id) {
+	Node<T1, T2, Augment> *node;
+	int res, depth;
+	countOp(SplayStats::OpFind);
+	if (root == NULL)
+		return NULL;
+	switch (std::is_same<Augment, NoAugment>::value ? policy.mode : SplayFull) {
+	case SplaySemi:
+		node = descend(id, &res, &depth);
+		splayUp(node, true);
+		break;
+	case SplayDepth:
+		node = descend(id, &res, &depth);
+		if (depth > policy.arg)
+			splayUp(node, false);
+		break;
+	case SplayRandom:
+		policy.seed ^= policy.seed << 13;
+		policy.seed ^= policy.seed >> 7;
+		policy.seed ^= policy.seed << 17;
+		if ((policy.seed >> 11) * (1.0 / 9007199254740992.0) >= policy.arg) {
+			node = descend(id, &res, &depth);
+			break;
+		}
+		// fall through
+	default:
+		root = node = splay(root, id, &res);
+	}
+	if (res != 0)
 		return NULL;
 	else
-		return root->getRcd();
+		return node->getRcd();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: peek
+// DESCRIPTION: To find the record of the node with ID "id" by a plain binary
+//				search, without splaying. Nothing is written, not even the
+//				SPLAY_STATS counters, so several threads may peek at once.
+//   ARGUMENTS: const T1 &id - the ID to search for
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2* - NULL if the node is not found
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+T2 *SplayTree<T1, T2, Compare, Alloc, Augment>::peek(const T1 &id) const {
+	const Node<T1, T2, Augment> *node = root;
+	int res;
+	while (node != NULL) {
+		res = Compare::operator()(id, node->getID());	// not counted
+		if (res == 0)
+			return node->getRcd();
+		node = res < 0 ? node->getLft() : node->getRgt();
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: sortBatch
+// DESCRIPTION: To sort the positions of a batch by ID; equal IDs keep their
+//				order in the batch.
+//   ARGUMENTS: const std::vector<V> &items - the IDs or (ID, record) pairs
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: std::vector<int> - the positions in increasing order of ID
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class V>
+std::vector<int> SplayTree<T1, T2, Compare, Alloc, Augment>::sortBatch(const std::vector<V> &items) const {
+	std::vector<int> order(items.size());
+	if (items.size() > 0x7fffffff)
+		throw SplayERR("Batch too large");
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = (int)i;
+	std::sort(order.begin(), order.end(), [this, &items](int a, int b) {
+		int res = compare(keyOf(items[a]), keyOf(items[b]));
+		return res < 0 || (res == 0 && a < b);
+	});
+	return order;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: findBatch
+// DESCRIPTION: To find a batch of IDs. They are splayed in increasing order,
+//				so by the sequential access property of splay trees nearby
+//				IDs cost O(1) amortized each instead of a walk from the top.
+//				The son of the root on the side of the next ID, where its
+//				search goes first, is prefetched. Unlike find, this always
+//				splays, whatever the splay mode.
+//   ARGUMENTS: const std::vector<T1> &keys - the IDs to search for
+//				std::vector<T2*> &out - gets the records in the order of
+//				"keys", NULL where the ID is not found
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int - the number of IDs found
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::findBatch(const std::vector<T1> &keys, std::vector<T2*> &out) {
+	std::vector<int> order = sortBatch(keys);
+	int n = (int)keys.size(), found = 0, res;
+	countOp(SplayStats::OpFind, keys.size());
+	out.assign(keys.size(), (T2*)NULL);
+	if (root == NULL)
+		return 0;
+	for (int i = 0; i < n; i++) {
+		root = splay(root, keys[order[i]], &res);
+		if (i + 1 < n)
+			prefetchNext(res);
+		if (res == 0) {
+			out[order[i]] = root->getRcd();
+			found++;
+		}
+	}
+	return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insertBatch
+// DESCRIPTION: To insert a batch of IDs or (ID, record) pairs, in increasing
+//				order of ID as findBatch does. Where an ID is repeated or is
+//				already there, the node there first is kept.
+//   ARGUMENTS: const std::vector<V> &items - the IDs or (ID, record) pairs
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int - the number of new nodes
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class V>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::insertBatch(const std::vector<V> &items) {
+	std::vector<int> order = sortBatch(items);
+	int n = (int)items.size(), added = 0, res = 0;
+	countOp(SplayStats::OpInsert, items.size());
+	for (int i = 0; i < n; i++) {
+		if (root != NULL) {
+			root = splay(root, keyOf(items[order[i]]), &res);
+			if (res == 0)
+				continue;
+		}
+		linkRoot(makeNode(items[order[i]]), res);
+		added++;
+		if (i + 1 < n)
+			prefetchNext(0);
+	}
+	return added;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: deleteBatch
+// DESCRIPTION: To delete a batch of IDs, in increasing order of ID as
+//				findBatch does.
+//   ARGUMENTS: const std::vector<T1> &keys - the IDs to delete
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int - the number of nodes deleted
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::deleteBatch(const std::vector<T1> &keys) {
+	std::vector<int> order = sortBatch(keys);
+	Node<T1, T2, Augment> *lft, *rgt;
+	int n = (int)keys.size(), deleted = 0, res;
+	countOp(SplayStats::OpDelete, keys.size());
+	for (int i = 0; i < n && root != NULL; i++) {
+		root = splay(root, keys[order[i]], &res);
+		if (res == 0) {
+			lft = root->getLft();
+			rgt = root->getRgt();
+			freeNode(root);
+			root = joinNodes(lft, rgt);
+			deleted++;
+			res = lft != NULL ? 1 : -1;	// the root is now the last node below or the first above
+		}
+		if (i + 1 < n && root != NULL)
+			prefetchNext(res);
+	}
+	return deleted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: lower_bound
+// DESCRIPTION: To find the first node whose ID is not less than "id". After
+//				the splay the root is either that node or, when "id" is above
+//				the root and the root has no right son, the last node.
+//   ARGUMENTS: const T1 &id - the ID to search for
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: iterator - end() if there is no such node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::iterator SplayTree<T1, T2, Compare, Alloc, Augment>::lower_bound(const T1 &id) {
+	int res;
+	countOp(SplayStats::OpOrdered);
+	if (root == NULL)
+		return end();
+	root = splay(root, id, &res);
+	if (res > 0)	// every ID in the left subtree is less, the right one is the answer
+		return iterator(splayNext(), &root);
+	return iterator(root, &root);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: upper_bound
+// DESCRIPTION: To find the first node whose ID is greater than "id". If "id"
+//				itself is found, its successor (the left most node of its
+//				right subtree) is splayed to the root.
+//   ARGUMENTS: const T1 &id - the ID to search for
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: iterator - end() if there is no such node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::iterator SplayTree<T1, T2, Compare, Alloc, Augment>::upper_bound(const T1 &id) {
+	int res;
+	countOp(SplayStats::OpOrdered);
+	if (root == NULL)
+		return end();
+	root = splay(root, id, &res);
+	if (res < 0)
+		return iterator(root, &root);
+	return iterator(splayNext(), &root);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: splayNext
+// DESCRIPTION: To splay the successor of the root (the left most node of its
+//				right subtree) to the root. No compare is needed.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: Node<T1, T2, Augment>* - the new root, NULL if the root is the last node
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::splayNext() {
+	Node<T1, T2, Augment> *tmp;
+	MinProbe toMin;
+	if (root->getRgt() == NULL)
+		return NULL;
+	tmp = splayBy(root->getRgt(), toMin);
+	root->AddRgt((Node<T1, T2, Augment>*)NULL);
+	tmp->AddLft(root);
+	root = tmp;
+	return root;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: equal_range
+// DESCRIPTION: To find the range of nodes whose ID is equal to "id".
+//   ARGUMENTS: const T1 &id - the ID to search for
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: std::pair<iterator, iterator>
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+std::pair<typename SplayTree<T1, T2, Compare, Alloc, Augment>::iterator, typename SplayTree<T1, T2, Compare, Alloc, Augment>::iterator>
+SplayTree<T1, T2, Compare, Alloc, Augment>::equal_range(const T1 &id) {
+	iterator first = lower_bound(id);
+	iterator last = upper_bound(id);	// keeps "first" valid: nodes are never moved
+	return std::make_pair(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: forEachInRange
+// DESCRIPTION: To call "fn" on every node whose ID is in [lo, hi), in order.
+//				The first node is splayed to the root, so scans of nearby
+//				ranges start close to the root.
+//   ARGUMENTS: const T1 &lo - the lowest ID of the range
+//				const T1 &hi - the ID just above the range
+//				Func fn - called as fn(const Node<T1, T2, Augment> &)
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int - the number of nodes visited
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class Func>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::forEachInRange(const T1 &lo, const T1 &hi, Func fn) {
+	int n = 0;
+	for (iterator it = lower_bound(lo); it != end() && compare(it->getID(), hi) < 0; ++it) {
+		fn(*it);
+		n++;
+	}
+	return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: countInRange
+// DESCRIPTION: To count the nodes whose ID is in [lo, hi) in O(log n), as the
+//				difference of two ranks.
+//   ARGUMENTS: const T1 &lo - the lowest ID of the range
+//				const T1 &hi - the ID just above the range
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::countInRange(const T1 &lo, const T1 &hi) {
+	int n;
+	if (compare(lo, hi) >= 0)
+		return 0;
+	n = rank(hi);
+	return n - rank(lo);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: rank
+// DESCRIPTION: To count the nodes whose ID is less than "id". After the splay
+//				every ID in the left subtree of the root is less than "id",
+//				and so is the root itself if "id" is above it.
+//   ARGUMENTS: const T1 &id - the ID to rank
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: int
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+int SplayTree<T1, T2, Compare, Alloc, Augment>::rank(const T1 &id) {
+	int res;
+	countOp(SplayStats::OpOrdered);
+	if (root == NULL)
+		return 0;
+	root = splay(root, id, &res);
+	return (root->getLft() == NULL ? 0 : root->getLft()->getCount()) + (res > 0 ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: select
+// DESCRIPTION: To find the node with "k" nodes before it (k counts from 0)
+//				and splay it to the root. No compare is needed.
+//   ARGUMENTS: int k - the rank of the node
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: iterator - end() if "k" is out of range
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::iterator SplayTree<T1, T2, Compare, Alloc, Augment>::select(int k) {
+	RankProbe probe = { k };
+	countOp(SplayStats::OpOrdered);
+	if (k < 0 || k >= getSize())
+		return end();
+	root = splayBy(root, probe);
+	return iterator(root, &root);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: aggregate
+// DESCRIPTION: To get the aggregate of the whole tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: aggregate_type - Augment::identity() if the tree is empty
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::aggregate_type SplayTree<T1, T2, Compare, Alloc, Augment>::aggregate() const {
+	if (root == NULL)
+		return Augment::identity();
+	return root->getAgg();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: aggregate
+// DESCRIPTION: To get the aggregate of the nodes whose ID is in [lo, hi).
+//				The first node of the range is splayed to the root, then the
+//				last node on the path to "hi" is splayed to the top of the
+//				root's right subtree. The range is then the root, the left
+//				subtree of that node and maybe that node itself, so only
+//				three aggregates are combined.
+//   ARGUMENTS: const T1 &lo - the lowest ID of the range
+//				const T1 &hi - the ID just above the range
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: aggregate_type - Augment::identity() if the range is empty
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::aggregate_type SplayTree<T1, T2, Compare, Alloc, Augment>::aggregate(const T1 &lo, const T1 &hi) {
+	Node<T1, T2, Augment> *tmp;
+	aggregate_type agg;
+	int res;
+	if (compare(lo, hi) >= 0 || lower_bound(lo) == end() || compare(root->getID(), hi) >= 0)
+		return Augment::identity();
+	agg = Augment::lift(root->getID(), *root->getRcd());
+	if (root->getRgt() == NULL)
+		return agg;
+	tmp = splay(root->getRgt(), hi, &res);
+	root->AddRgt(tmp);
+	if (tmp->getLft() != NULL)
+		agg = Augment::combine(agg, tmp->getLft()->getAgg());
+	if (res > 0)
+		agg = Augment::combine(agg, Augment::lift(tmp->getID(), *tmp->getRcd()));
+	return agg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: refresh
+// DESCRIPTION: To recompute the aggregate of the root. It must be called after
+//				the record got from find() (which, whatever the splay mode,
+//				splays the node to the root on a tree with an Augment policy)
+//				is changed, before the tree is used again.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false if the tree is empty
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::refresh() {
+	if (root == NULL)
+		return false;
+	return root->UpdateAgg();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: Insert
 // DESCRIPTION: The user interface of inserting a node into the Splay tree.
+//				The tree is splayed at "id" first; if "id" is not there, the
+//				new node becomes the root and takes the old root to one side.
 //   ARGUMENTS: const T1 &id - the id of the new node that is to be inserted
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::Insert(const T1 &id) {
-	Node<T1, T2> *tmp = root;
-	Node<T1, T2> *nxt = root;
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::Insert(const T1 &id) {
+	int res = 0;
+	countOp(SplayStats::OpInsert);
 
-	// special case
-	if (root == NULL) {
-		root = new Node<T1, T2>(id);
-		if (root == NULL) {
-			throw SplayERR("Out of space");
-			return false;
-		}
-		return true;
+	// find the position to insert
+	if (root != NULL) {
+		root = splay(root, id, &res);
+		if (res == 0)
+			return true;
 	}
 
-	// find the position to insert
-	do {
-		tmp = nxt;
-		if (cmp(id, tmp->getID()) < 0)
-			nxt = tmp->getLft();
-		else if (cmp(id, tmp->getID()) > 0)
-			nxt = tmp->getRgt();
-		else
-			break;
-	} while (nxt != NULL);
-	
 	// insert
-	if (cmp(id, tmp->getID()) == 0)
-		return true;
-	if (cmp(id, tmp->getID()) < 0)
-		tmp->AddLft(id);
-	else if (cmp(id, tmp->getID()) > 0)
-		tmp->AddRgt(id);
+	linkRoot(newNode(id), res);
+	return true;
+}
 
-	// splay
-	root = splay(root, id);
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: The user interface of inserting a node into the Splay tree.
+//				The ID is moved into the new node.
+//   ARGUMENTS: T1 &&id - the id of the new node that is to be inserted
+// USES GLOBAL: none
+// MODIFIES GL: root (possible)
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::Insert(T1 &&id) {
+	int res = 0;
+	countOp(SplayStats::OpInsert);
+	if (root != NULL) {
+		root = splay(root, id, &res);
+		if (res == 0)
+			return true;
+	}
+	linkRoot(newNode(EmplaceRcd(), std::move(id)), res);
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: emplace
+// DESCRIPTION: To insert a node whose ID is built in place from "args". The
+//				node is built first; if the ID is already there it is freed.
+//   ARGUMENTS: Args&&... args - the arguments for the constructor of T1
+// USES GLOBAL: none
+// MODIFIES GL: root (possible)
+//     RETURNS: std::pair<T2*, bool> - the record of the node with that ID, and
+//				whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class... Args>
+std::pair<T2*, bool> SplayTree<T1, T2, Compare, Alloc, Augment>::emplace(Args&&... args) {
+	Node<T1, T2, Augment> *node = newNode(EmplaceID(), std::forward<Args>(args)...);
+	int res = 0;
+	countOp(SplayStats::OpInsert);
+	if (root != NULL) {
+		root = splay(root, node->getID(), &res);
+		if (res == 0) {
+			freeNode(node);
+			return std::make_pair(root->getRcd(), false);
+		}
+	}
+	linkRoot(node, res);
+	return std::make_pair(node->getRcd(), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: try_emplace
+// DESCRIPTION: To insert a node with ID "id" whose record is built in place
+//				from "args". Nothing is built if the ID is already there.
+//   ARGUMENTS: K &&id - the ID of the node
+//				Args&&... args - the arguments for the constructor of T2
+// USES GLOBAL: none
+// MODIFIES GL: root (possible)
+//     RETURNS: std::pair<T2*, bool> - the record of the node with that ID, and
+//				whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class K, class... Args>
+std::pair<T2*, bool> SplayTree<T1, T2, Compare, Alloc, Augment>::try_emplace(K &&id, Args&&... args) {
+	Node<T1, T2, Augment> *node;
+	int res = 0;
+	countOp(SplayStats::OpInsert);
+	if (root != NULL) {
+		root = splay(root, id, &res);
+		if (res == 0)
+			return std::make_pair(root->getRcd(), false);
+	}
+	node = newNode(EmplaceRcd(), std::forward<K>(id), std::forward<Args>(args)...);
+	linkRoot(node, res);
+	return std::make_pair(node->getRcd(), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insert_or_assign
+// DESCRIPTION: To insert a node with ID "id" and record "rcd", or to assign
+//				"rcd" to the record if the ID is already there, by one splay.
+//				Either way the node ends at the root, so its aggregate is the
+//				only one to bring up to date.
+//   ARGUMENTS: const T1 &id - the ID of the node
+//				R &&rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: std::pair<T2*, bool> - the record, and whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class R>
+std::pair<T2*, bool> SplayTree<T1, T2, Compare, Alloc, Augment>::insert_or_assign(const T1 &id, R &&rcd) {
+	std::pair<T2*, bool> res = try_emplace(id, std::forward<R>(rcd));	// "rcd" is left alone if "id" is there
+	if (!res.second) {
+		*res.first = std::forward<R>(rcd);
+		root->UpdateAgg();
+	}
+	return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: upsert
+// DESCRIPTION: To call "fn" on the record of "id", inserting the ID with a
+//				default record first if it is not there, by one splay.
+//   ARGUMENTS: const T1 &id - the ID of the node
+//				Func fn - called as fn(T2 &) on the record
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: std::pair<T2*, bool> - the record, and whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+template<class Func>
+std::pair<T2*, bool> SplayTree<T1, T2, Compare, Alloc, Augment>::upsert(const T1 &id, Func fn) {
+	std::pair<T2*, bool> res = try_emplace(id);
+	fn(*res.first);
+	root->UpdateAgg();
+	return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: Delete
 // DESCRIPTION: The user interface of deleting a node into the Splay tree.
@@ -1143,27 +2997,278 @@ bool SplayTree<T1, T2>::Insert(const T1 &id) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::Delete(const T1 &id) {
-	Node<T1, T2>* tmp;
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::Delete(const T1 &id) {
+	Node<T1, T2, Augment> *lft, *rgt;
+	int res;
+	countOp(SplayStats::OpDelete);
 
 	// the tree is empty
 	if (root == NULL)
 		return true;
 
-	root = splay(root, id);
-	if (cmp(id, root->getID()) != 0)
+	root = splay(root, id, &res);
+	if (res != 0)
 		return true;
-	if (root->getLft() == NULL)
-		tmp = root->getRgt();
+	lft = root->getLft();
+	rgt = root->getRgt();
+	freeNode(root);
+	root = joinNodes(lft, rgt);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: extract
+// DESCRIPTION: To take the node with ID "id" out of the Splay tree. It is cut
+//				off the same way as in Delete, but handed back instead of freed.
+//   ARGUMENTS: const T1 &id - the ID of the node that is to be taken out
+// USES GLOBAL: none
+// MODIFIES GL: root (possible)
+//     RETURNS: node_type - the handle of the node, empty if "id" is not there
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+typename SplayTree<T1, T2, Compare, Alloc, Augment>::node_type SplayTree<T1, T2, Compare, Alloc, Augment>::extract(const T1 &id) {
+	Node<T1, T2, Augment> *node, *lft, *rgt;
+	int res;
+	countOp(SplayStats::OpDelete);
+	if (root == NULL)
+		return node_type();
+	root = splay(root, id, &res);
+	if (res != 0)
+		return node_type();
+	node = root;
+	lft = node->getLft();
+	rgt = node->getRgt();
+	node->AddLft((Node<T1, T2, Augment>*)NULL);
+	node->AddRgt((Node<T1, T2, Augment>*)NULL);
+	root = joinNodes(lft, rgt);
+	return node_type(node, alloc);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insert
+// DESCRIPTION: To insert the node held by "nh". The node itself is linked in
+//				when "nh" came from an equal allocator, otherwise a copy is
+//				made and the node is freed. If the ID is already there nothing
+//				is done and "nh" keeps its node.
+//   ARGUMENTS: node_type &&nh - the handle of the node
+// USES GLOBAL: none
+// MODIFIES GL: root (possible)
+//     RETURNS: std::pair<T2*, bool> - the record of the node with that ID (NULL
+//				for an empty handle), and whether the node is new
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+std::pair<T2*, bool> SplayTree<T1, T2, Compare, Alloc, Augment>::insert(node_type &&nh) {
+	Node<T1, T2, Augment> *node;
+	int res = 0;
+	if (nh.empty())
+		return std::make_pair((T2*)NULL, false);
+	countOp(SplayStats::OpInsert);
+	if (root != NULL) {
+		root = splay(root, nh.key(), &res);
+		if (res == 0)
+			return std::make_pair(root->getRcd(), false);
+	}
+	if (alloc == nh.alloc)
+		node = nh.release();
 	else {
-		tmp = root->getLft();
-		tmp = splay(tmp, id);
-		tmp->AddRgt(root->getRgt());
+		node = newNode(nh.key(), nh.mapped());
+		nh.reset();
+	}
+	node->UpdateAgg();	// the record may have been changed through the handle
+	linkRoot(node, res);
+	return std::make_pair(node->getRcd(), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: joinNodes
+// DESCRIPTION: To join two detached subtrees where every ID in "lft" is less
+//				than every ID in "rgt". The right most node of "lft" is
+//				splayed up and "rgt" hung on its empty right side.
+//   ARGUMENTS: Node<T1, T2, Augment> *lft - the root of the left subtree
+//				Node<T1, T2, Augment> *rgt - the root of the right subtree
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Augment>* - the root of the joined tree
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::joinNodes(Node<T1, T2, Augment> *lft, Node<T1, T2, Augment> *rgt) {
+	MaxProbe toMax;
+	if (lft == NULL) {
+		if (rgt != NULL)
+			rgt->ModifyPar((Node<T1, T2, Augment>*)NULL);
+		return rgt;
+	}
+	lft->ModifyPar((Node<T1, T2, Augment>*)NULL);
+	lft = splayBy(lft, toMax);	// no compare needed
+	lft->AddRgt(rgt);
+	return lft;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: adopt
+// DESCRIPTION: To take all the nodes of "b", leaving it empty. The nodes are
+//				moved when the two allocators are equal (e.g. PoolAllocs that
+//				share an arena), otherwise they have to be copied.
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &b - the tree to take from
+// USES GLOBAL: none
+// MODIFIES GL: alloc
+//     RETURNS: Node<T1, T2, Augment>* - the root of the nodes taken
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+Node<T1, T2, Augment>* SplayTree<T1, T2, Compare, Alloc, Augment>::adopt(SplayTree<T1, T2, Compare, Alloc, Augment> &b) {
+	Node<T1, T2, Augment> *tmp;
+	if (alloc == b.alloc) {
+		tmp = b.root;
+		b.root = NULL;
+	}
+	else {
+		tmp = copyTree(b.root);
+		b.empty();
+	}
+	return tmp;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: split
+// DESCRIPTION: To split the Splay tree at "id". The nodes whose ID is not
+//				less than "id" are moved to the returned tree, which shares
+//				the compare function, the allocator and the splay mode (see
+//				setSplayMode). Nothing is allocated or copied: it is one
+//				splay and one cut.
+//   ARGUMENTS: const T1 &id - the lowest ID of the right part
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: SplayTree<T1, T2, Compare, Alloc, Augment>
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+SplayTree<T1, T2, Compare, Alloc, Augment> SplayTree<T1, T2, Compare, Alloc, Augment>::split(const T1 &id) {
+	SplayTree<T1, T2, Compare, Alloc, Augment> right(static_cast<const Compare&>(*this), Alloc(alloc));
+	int res;
+	right.policy = policy;
+	countOp(SplayStats::OpReshape);
+	if (root == NULL)
+		return right;
+	root = splay(root, id, &res);
+	if (res <= 0) {	// the root goes right
+		right.root = root;
+		root = root->getLft();
+		right.root->AddLft((Node<T1, T2, Augment>*)NULL);
+	}
+	else {
+		right.root = root->getRgt();
+		root->AddRgt((Node<T1, T2, Augment>*)NULL);
+	}
+	if (root != NULL)
+		root->ModifyPar((Node<T1, T2, Augment>*)NULL);
+	if (right.root != NULL)
+		right.root->ModifyPar((Node<T1, T2, Augment>*)NULL);
+	return right;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: join
+// DESCRIPTION: To move all the nodes of "right" to the end of this tree. Every
+//				ID in "right" must be greater than every ID here; this is
+//				checked with a single compare of this tree's maximum and the
+//				minimum of "right", both splayed to their roots.
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &right - left empty
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool - false (and nothing moved) if the ID ranges overlap
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::join(SplayTree<T1, T2, Compare, Alloc, Augment> &right) {
+	MaxProbe toMax;
+	MinProbe toMin;
+	countOp(SplayStats::OpReshape);
+	if (&right == this || right.root == NULL)
+		return true;
+	if (root != NULL) {
+		root = splayBy(root, toMax);
+		right.root = right.splayBy(right.root, toMin);
+		if (compare(root->getID(), right.root->getID()) >= 0)
+			return false;
+	}
+	root = joinNodes(root, adopt(right));
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: merge
+// DESCRIPTION: To move all the nodes of "other" into this tree. When the two
+//				ID ranges do not overlap this is a join on either side.
+//				Otherwise the nodes of "other" are rotated into an ascending
+//				chain and linked in one by one at the root, so each splay
+//				starts next to the previous one. The nodes are moved, not
+//				copied, unless the two allocators differ (e.g. PoolAllocs
+//				with separate arenas; see adopt). Where an ID is in both
+//				trees the node of this tree is kept.
+//   ARGUMENTS: SplayTree<T1, T2, Compare, Alloc, Augment> &other - left empty
+// USES GLOBAL: none
+// MODIFIES GL: root
+//     RETURNS: bool
+//      AUTHOR: SplayTree contributors
+// AUTHOR/DATE: SC 2026-10-18
+//							SC 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::merge(SplayTree<T1, T2, Compare, Alloc, Augment> &other) {
+	Node<T1, T2, Augment> *node, *tmp;
+	MaxProbe toMax;
+	MinProbe toMin;
+	int res;
+	if (&other == this || other.root == NULL)
+		return true;
+
+	// fast paths: the ranges do not overlap
+	if (join(other))
+		return true;
+	root = splayBy(root, toMin);
+	other.root = other.splayBy(other.root, toMax);
+	if (compare(other.root->getID(), root->getID()) < 0) {
+		root = joinNodes(adopt(other), root);
+		return true;
+	}
+
+	node = adopt(other);
+	while (node != NULL) {
+		tmp = node->getLft();
+		if (tmp != NULL) {	// rotate right
+			node->AddLft(tmp->getRgt());
+			tmp->AddRgt(node);
+		}
+		else {	// "node" is the least one left
+			tmp = node->getRgt();
+			node->AddRgt((Node<T1, T2, Augment>*)NULL);
+			root = splay(root, node->getID(), &res);
+			if (res == 0)
+				freeNode(node);
+			else
+				linkRoot(node, res);
+		}
+		node = tmp;
 	}
-	root = tmp;
 	return true;
 }
 
@@ -1176,10 +3281,10 @@ bool SplayTree<T1, T2>::Delete(const T1 &id) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-11
-//							KC 2015-02-11
+//							SC 2026-10-18
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool SplayTree<T1, T2>::print() const {
+template<class T1, class T2, class Compare, class Alloc, class Augment>
+bool SplayTree<T1, T2, Compare, Alloc, Augment>::print() const {
 	if (root != NULL) {
 		root->print();
 		return true;
@@ -0,0 +1,672 @@
+// Micro benchmarks for SplayTree.
+// Build: g++ -O2 -std=c++17 -pthread bench.cpp -o bench  (add -DSPLAY_STATS for links written per lookup)
+#include "SplayTree.h"
+#include "SplaySequence.h"
+#include "ConcurrentSplayTree.h"
+#include "ShardedSplayTree.h"
+#include "SplayCache.h"
+#include "CompactSplayTree.h"
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <new>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <list>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <fstream>
+#include <string>
+using namespace std;
+
+// every call of the global operator new is counted
+static atomic<unsigned long long> nAlloc(0);
+
+void *operator new(size_t n) {
+	nAlloc++;
+	void *p = malloc(n ? n : 1);
+	if (p == NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static double msSince(chrono::steady_clock::time_point t0) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// insert every key of "ins", then look up every key of "qry"
+template<class Tree>
+static void runSplay(const char *name, const vector<int> &ins, const vector<int> &qry) {
+	Tree ST;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < ins.size(); i++)
+		ST.Insert(ins[i]);
+	double tIns = msSince(t0);
+	long long hit = 0;
+	t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < qry.size(); i++)
+		if (ST.find(qry[i]) != NULL)
+			hit++;
+	double tFind = msSince(t0);
+	cout << name << ": n=" << ins.size() << "  insert " << tIns << " ms  find " << tFind
+		<< " ms  (" << hit << " hits)" << endl;
+}
+
+// n keys drawn from a Zipf distribution over "universe" ranks with exponent "skew";
+// the ranks are shuffled so that hot keys are spread over the key space
+static vector<int> zipfKeys(int n, int universe, double skew, unsigned seed) {
+	mt19937 rng(seed);
+	vector<double> cdf(universe);
+	double sum = 0;
+	for (int i = 0; i < universe; i++) {
+		sum += 1.0 / pow((double)(i + 1), skew);
+		cdf[i] = sum;
+	}
+	vector<int> perm(universe);
+	for (int i = 0; i < universe; i++)
+		perm[i] = i;
+	shuffle(perm.begin(), perm.end(), rng);
+	uniform_real_distribution<double> u(0, sum);
+	vector<int> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = perm[lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()];
+	return keys;
+}
+
+// insert all the keys and report inserts per second
+template<class Tree>
+static void runInsert(const char *name, const vector<int> &keys) {
+	Tree ST;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < keys.size(); i++)
+		ST.Insert(keys[i]);
+	double t = msSince(t0);
+	cout << name << ": " << keys.size() << " inserts " << t << " ms  "
+		<< (long long)(keys.size() / t * 1000) << " inserts/s" << endl;
+}
+
+// cold start: load n sorted keys one by one, in bulk, and in bulk from shuffled keys
+static void runColdStart(int n) {
+	mt19937 rng(4242);
+	vector<int> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = i;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	{
+		SplayTree<int, NULLT, DefCmp<int> > ST;
+		for (int i = 0; i < n; i++)
+			ST.Insert(keys[i]);
+		ST.find(n / 2);	// the first lookup pays for the chain
+	}
+	cout << "Insert loop + first find: " << msSince(t0) << " ms" << endl;
+	t0 = chrono::steady_clock::now();
+	{
+		SplayTree<int, NULLT, DefCmp<int> > ST;
+		ST.bulkLoad(keys.begin(), keys.end());
+		ST.find(n / 2);
+	}
+	cout << "bulkLoad + first find: " << msSince(t0) << " ms" << endl;
+	shuffle(keys.begin(), keys.end(), rng);
+	t0 = chrono::steady_clock::now();
+	{
+		SplayTree<int, NULLT, DefCmp<int> > ST;
+		ST.bulkLoadUnsorted(keys.begin(), keys.end());
+		ST.find(n / 2);
+	}
+	cout << "bulkLoadUnsorted (shuffled) + first find: " << msSince(t0) << " ms" << endl;
+}
+
+// resident set size in kB, from /proc (0 where there is none)
+static long rssKB() {
+	ifstream in("/proc/self/status");
+	string key;
+	long kb = 0;
+	while (in >> key)
+		if (key == "VmRSS:") {
+			in >> kb;
+			break;
+		}
+	return kb;
+}
+
+// heap in use in kB, mmapped blocks included (glibc), or the RSS elsewhere
+static long heapKB() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	struct mallinfo2 mi = mallinfo2();
+	return (long)((mi.uordblks + mi.hblkhd) / 1024);
+#else
+	return rssKB();
+#endif
+}
+
+// delete a random key and insert a fresh one, "rounds" times, on a tree of n keys;
+// the size must stay n and the RSS must not grow with the number of rounds
+template<class Tree>
+static void runChurn(const char *name, int n, int rounds) {
+	mt19937 rng(777);
+	Tree ST;
+	vector<int> live(n);
+	for (int i = 0; i < n; i++)
+		ST.Insert(live[i] = i);
+	int nxt = n;
+	unsigned long long a0 = nAlloc;
+	long r0 = rssKB(), rHalf = 0;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		int &k = live[rng() % n];
+		ST.Delete(k);
+		ST.Insert(k = nxt++);
+		if (i == rounds / 2)
+			rHalf = rssKB();
+	}
+	double t = msSince(t0);
+	cout << name << ": n=" << n << "  " << rounds << " delete+insert " << t << " ms  "
+		<< (nAlloc - a0) << " allocations  size " << ST.getSize() << "  RSS +" << rHalf - r0
+		<< " kB at half, +" << rssKB() - r0 << " kB at the end" << endl;
+}
+
+// move every key between two trees through extract and insert(node_type &&)
+template<class Tree>
+static void runExtract(const char *name, Tree &a, Tree &b, int n, int rounds) {
+	for (int i = 0; i < n; i++)
+		a.Insert(i);
+	unsigned long long a0 = nAlloc;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (int i = 0; i < n; i++)
+			(r % 2 ? a : b).insert((r % 2 ? b : a).extract(i));
+	double t = msSince(t0);
+	cout << name << ": " << (long long)rounds * n << " moves " << t << " ms  "
+		<< (nAlloc - a0) << " allocations  sizes " << a.getSize() << " " << b.getSize() << endl;
+}
+
+// slide a window of w keys over n keys in steps of "step" and sum the IDs in each window
+static void runRangeScan(int n, int w, int step) {
+	mt19937 rng(31337);
+	vector<int> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = 2 * i;	// every other integer, so window bounds often miss
+	shuffle(keys.begin(), keys.end(), rng);
+	SplayTree<int, NULLT, DefCmp<int> > ST;
+	map<int, int> M;
+	for (int i = 0; i < n; i++) {
+		ST.Insert(keys[i]);
+		M[keys[i]] = 0;
+	}
+	long long sum = 0;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int lo = 0; lo < 2 * n; lo += step)
+		ST.forEachInRange(lo, lo + 2 * w, [&sum](const Node<int> &nd) { sum += nd.getID(); });
+	double tSplay = msSince(t0);
+	long long sum2 = 0;
+	t0 = chrono::steady_clock::now();
+	for (int lo = 0; lo < 2 * n; lo += step)
+		for (map<int, int>::iterator it = M.lower_bound(lo); it != M.end() && it->first < lo + 2 * w; ++it)
+			sum2 += it->first;
+	double tMap = msSince(t0);
+	cout << "window " << w << " step " << step << ": SplayTree " << tSplay << " ms  std::map "
+		<< tMap << " ms" << (sum == sum2 ? "" : "  MISMATCH") << endl;
+}
+
+// move the upper half of n keys to another tree: split vs delete and re-insert
+static void runSplit(int n) {
+	mt19937 rng(2024);
+	vector<int> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = i;
+	shuffle(keys.begin(), keys.end(), rng);
+	typedef SplayTree<int, NULLT, DefCmp<int> > Tree;
+	Tree A, B;
+	for (int i = 0; i < n; i++) {
+		A.Insert(keys[i]);
+		B.Insert(keys[i]);
+	}
+	unsigned long long a0 = nAlloc;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	Tree A2 = A.split(n / 2);
+	A.join(A2);
+	double tSplit = msSince(t0);
+	unsigned long long aSplit = nAlloc - a0;
+	t0 = chrono::steady_clock::now();
+	Tree B2;
+	for (int i = n / 2; i < n; i++) {
+		B.Delete(i);
+		B2.Insert(i);
+	}
+	for (int i = n / 2; i < n; i++)
+		B.Insert(i);
+	cout << "split + join: " << tSplit << " ms, " << aSplit << " allocations  re-insert: "
+		<< msSince(t0) << " ms" << endl;
+}
+
+// p50/p99 of a sliding window of the last w latencies: select vs walking the iterators
+static void runPercentile(int rounds, int w) {
+	mt19937 rng(99);
+	lognormal_distribution<double> lat(3.0, 0.8);
+	vector<pair<int, int> > win;	// (latency, sequence number) keeps IDs unique
+	SplayTree<pair<int, int>, NULLT, LessCmp<pair<int, int> > > ST;
+	long long sum = 0, sum2 = 0;
+	double tSel = 0, tWalk = 0;
+	for (int i = 0; i < rounds; i++) {
+		pair<int, int> id((int)lat(rng), i);
+		win.push_back(id);
+		ST.Insert(id);
+		if ((int)win.size() > w)
+			ST.Delete(win[win.size() - w - 1]);
+		if (i % 64 != 63)
+			continue;
+		int n = ST.getSize();
+		chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+		sum += ST.select(n / 2)->getID().first + ST.select(n * 99 / 100)->getID().first;
+		tSel += msSince(t0);
+		t0 = chrono::steady_clock::now();
+		SplayTree<pair<int, int>, NULLT, LessCmp<pair<int, int> > >::iterator it = ST.begin();
+		for (int j = 0; j < n / 2; j++)
+			++it;
+		sum2 += it->getID().first;
+		for (int j = n / 2; j < n * 99 / 100; j++)
+			++it;
+		sum2 += it->getID().first;
+		tWalk += msSince(t0);
+	}
+	cout << "window " << w << ": select " << tSel << " ms  iterator walk " << tWalk << " ms"
+		<< (sum == sum2 ? "" : "  MISMATCH") << endl;
+}
+
+// sums the records of a subtree
+struct SumRcd {
+	typedef long long value_type;
+	static long long identity() { return 0; }
+	static long long lift(const int &, const int &rcd) { return rcd; }
+	static long long combine(const long long &a, const long long &b) { return a + b; }
+};
+
+// sum of the records over random ranges of about w keys: aggregate vs a range scan
+static void runAggregate(int n, int w, int rounds) {
+	mt19937 rng(555);
+	SplayTree<int, int, DefCmp<int>, allocator<int>, SumRcd> ST;
+	for (int i = 0; i < n; i++)
+		ST.try_emplace(i, (int)(rng() % 1000));
+	long long sum = 0, sum2 = 0;
+	vector<int> lo(rounds);
+	for (int i = 0; i < rounds; i++)
+		lo[i] = (int)(rng() % n);
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++)
+		sum += ST.aggregate(lo[i], lo[i] + w);
+	double tAgg = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++)
+		ST.forEachInRange(lo[i], lo[i] + w, [&sum2](const Node<int, int, SumRcd> &nd) { sum2 += *nd.getRcd(); });
+	cout << "range " << w << ": aggregate " << tAgg << " ms  forEachInRange " << msSince(t0) << " ms"
+		<< (sum == sum2 ? "" : "  MISMATCH") << endl;
+}
+
+// random insert-at / erase / reverse on a sequence of n ints: SplaySequence vs vector
+static void runSequence(int n, int rounds) {
+	mt19937 rng(8080);
+	vector<int> V(n);
+	for (int i = 0; i < n; i++)
+		V[i] = i;
+	SplaySequence<int> SQ(V.begin(), V.end());
+	vector<int> pos(rounds), len(rounds);
+	for (int i = 0; i < rounds; i++) {
+		pos[i] = (int)(rng() % (n / 2));
+		len[i] = (int)(rng() % 1000);
+	}
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		SQ.insertAt(pos[i], i);
+		SQ.erase(pos[i] + 1);
+		SQ.reverse(pos[i], pos[i] + len[i]);
+	}
+	double tSeq = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		V.insert(V.begin() + pos[i], i);
+		V.erase(V.begin() + pos[i] + 1);
+		reverse(V.begin() + pos[i], V.begin() + pos[i] + len[i]);
+	}
+	double tVec = msSince(t0);
+	long long h1 = 0, h2 = 0;
+	SQ.forEach([&h1](const int &x) { h1 = h1 * 31 + x; });
+	for (size_t i = 0; i < V.size(); i++)
+		h2 = h2 * 31 + V[i];
+	cout << "n=" << n << "  " << rounds << " insert+erase+reverse: SplaySequence " << tSeq
+		<< " ms  vector " << tVec << " ms" << (h1 == h2 ? "" : "  MISMATCH") << endl;
+}
+
+// "threads" threads share "total" lookups of "keys"; returns millions of lookups per second
+template<class Lookup>
+static double runThreads(int threads, int total, const vector<int> &keys, Lookup lookup) {
+	vector<thread> pool;
+	atomic<long long> hits(0);
+	int per = total / threads;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++)
+		pool.push_back(thread([&, t]() {
+			long long h = 0;
+			for (int i = 0; i < per; i++)
+				if (lookup(keys[((size_t)t * per + i) % keys.size()]))
+					h++;
+			hits += h;
+		}));
+	for (size_t t = 0; t < pool.size(); t++)
+		pool[t].join();
+	return (double)per * threads / msSince(t0) / 1000;
+}
+
+// lookups under each splay mode of find; links written per lookup need -DSPLAY_STATS
+static void runModes(const char *name, int n, const vector<int> &qry) {
+	const char *names[] = { "full", "semi", "depth>2lg(n)", "random 1/16" };
+	SplayMode modes[] = { SplayFull, SplaySemi, SplayDepth, SplayRandom };
+	double args[] = { 0, 0, 2 * log2((double)n), 1.0 / 16 };
+	vector<int> ins(n);
+	for (int i = 0; i < n; i++)
+		ins[i] = i;
+	shuffle(ins.begin(), ins.end(), mt19937(777));
+	long long hit = 0;
+	cout << name << " (Mlookups/s):";
+	for (int m = 0; m < 4; m++) {
+		SplayTree<int, NULLT, DefCmp<int> > ST;
+		for (int i = 0; i < n; i++)
+			ST.Insert(ins[i]);
+		ST.setSplayMode(modes[m], args[m]);
+#ifdef SPLAY_STATS
+		ST.resetLinkCount();
+#endif
+		chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+		for (size_t i = 0; i < qry.size(); i++)
+			if (ST.find(qry[i]) != NULL)
+				hit++;
+		cout << "  " << names[m] << " " << qry.size() / msSince(t0) / 1000;
+#ifdef SPLAY_STATS
+		cout << " (" << (double)ST.getLinkCount() / qry.size() << " links)";
+#endif
+	}
+	cout << "  (" << hit << " hits)" << endl;
+}
+
+// batches of random keys: a find/Delete/Insert per key vs findBatch/deleteBatch/insertBatch
+static void runBatch(int n, int b) {
+	typedef SplayTree<int, NULLT, DefCmp<int> > Tree;
+	mt19937 rng(1357);
+	vector<int> ins(n);
+	for (int i = 0; i < n; i++)
+		ins[i] = 2 * i;
+	shuffle(ins.begin(), ins.end(), rng);
+	Tree loop, batch;
+	loop.insertBatch(ins);
+	batch.insertBatch(ins);
+	vector<vector<int> > batches(4 * n / b, vector<int>(b));
+	for (size_t i = 0; i < batches.size(); i++)
+		for (int j = 0; j < b; j++)
+			batches[i][j] = (int)(rng() % (2 * n));
+	vector<NULLT*> out;
+	long long hit = 0, hit2 = 0;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < batches.size(); i++)
+		for (int j = 0; j < b; j++)
+			if (loop.find(batches[i][j]) != NULL)
+				hit++;
+	double tLoop = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < batches.size(); i++)
+		hit2 += batch.findBatch(batches[i], out);
+	double tBatch = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < batches.size(); i += 2) {
+		for (int j = 0; j < b; j++)
+			loop.Delete(batches[i][j]);
+		for (int j = 0; j < b; j++)
+			loop.Insert(batches[i][j]);
+	}
+	double tLoopMod = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < batches.size(); i += 2) {
+		batch.deleteBatch(batches[i]);
+		batch.insertBatch(batches[i]);
+	}
+	double tBatchMod = msSince(t0);
+	cout << "batch " << b << ": find loop " << tLoop << " ms  findBatch " << tBatch << " ms  delete+insert loop "
+		<< tLoopMod << " ms  batch " << tBatchMod << " ms" << (hit == hit2 && loop.getSize() == batch.getSize()
+		? "" : "  MISMATCH") << endl;
+}
+
+// get-or-put of every key of "keys" through a cache of "cap" entries: SplayCache
+// in both evict modes vs a SplayTree of std::list iterators beside a std::list
+static void runCache(const char *name, int cap, const vector<int> &keys) {
+	typedef SplayTree<int, list<pair<int, int> >::iterator, DefCmp<int> > Index;
+	long long hit[3] = { 0, 0, 0 };
+	double t[3];
+	unsigned long long a[3];
+	for (int m = 0; m < 2; m++) {
+		SplayCache<int, int, DefCmp<int> > C(cap, 0, m == 0 ? EvictLRU : EvictDeep);
+		unsigned long long a0 = nAlloc;
+		chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+		for (size_t i = 0; i < keys.size(); i++)
+			if (C.get(keys[i]) == NULL)
+				C.put(keys[i], (int)i);
+		t[m] = msSince(t0);
+		a[m] = nAlloc - a0;
+		hit[m] = C.getHitCount();
+	}
+	Index idx;
+	list<pair<int, int> > lru;
+	unsigned long long a0 = nAlloc;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < keys.size(); i++) {
+		list<pair<int, int> >::iterator *it = idx.find(keys[i]);
+		if (it != NULL) {
+			lru.splice(lru.end(), lru, *it);
+			hit[2]++;
+			continue;
+		}
+		if ((int)lru.size() == cap) {
+			idx.Delete(lru.front().first);
+			lru.pop_front();
+		}
+		lru.push_back(make_pair(keys[i], (int)i));
+		idx.try_emplace(keys[i], --lru.end());
+	}
+	t[2] = msSince(t0);
+	a[2] = nAlloc - a0;
+	const char *names[3] = { "SplayCache LRU", "SplayCache deep", "SplayTree + std::list" };
+	for (int m = 0; m < 3; m++)
+		cout << name << " cap " << cap << "  " << names[m] << ": " << t[m] << " ms  hit ratio "
+			<< (double)hit[m] / keys.size() << "  " << a[m] << " allocations" << endl;
+}
+
+// random inserts and finds: Node pointers vs 32 bit indices in one vector
+template<class Tree>
+static void runStorage(const char *name, const vector<int> &keys, const vector<int> &qry) {
+	long r0 = heapKB();
+	Tree ST;
+	long long hit = 0;
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < keys.size(); i++)
+		ST.Insert(keys[i]);
+	double tIns = msSince(t0);
+	t0 = chrono::steady_clock::now();
+	for (size_t i = 0; i < qry.size(); i++)
+		if (ST.find(qry[i]) != NULL)
+			hit++;
+	double tFind = msSince(t0);
+	long kb = heapKB() - r0;
+	cout << name << ": insert " << tIns << " ms  find " << tFind << " ms  heap +" << kb << " kB  ("
+		<< kb * 1024.0 / keys.size() << " bytes/key, " << hit << " hits)" << endl;
+}
+
+// Zipf lookups: one mutex around SplayTree::find vs ConcurrentSplayTree in each adapt mode
+static void runConcurrent(int n) {
+	vector<int> keys = zipfKeys(4 * n, n, 0.99, 1234);
+	SplayTree<int, NULLT, DefCmp<int> > ST;
+	mutex m;
+	ConcurrentSplayTree<int, NULLT, DefCmp<int> > never(AdaptNever), rnd(AdaptRandom, 64), bat(AdaptBatched, 256);
+	mt19937 rng(4321);
+	vector<int> ins(n);
+	for (int i = 0; i < n; i++)
+		ins[i] = i;
+	shuffle(ins.begin(), ins.end(), rng);
+	for (int i = 0; i < n; i++) {
+		ST.Insert(ins[i]);
+		never.Insert(ins[i]);
+		rnd.Insert(ins[i]);
+		bat.Insert(ins[i]);
+	}
+	int threads[] = { 1, 4, 16, 32 };
+	for (int i = 0; i < 4; i++) {
+		double tMutex = runThreads(threads[i], 4 * n, keys, [&](int k) {
+			lock_guard<mutex> lock(m);
+			return ST.find(k) != NULL;
+		});
+		double tNever = runThreads(threads[i], 4 * n, keys, [&](int k) { return never.find(k); });
+		double tRnd = runThreads(threads[i], 4 * n, keys, [&](int k) { return rnd.find(k); });
+		double tBat = runThreads(threads[i], 4 * n, keys, [&](int k) { return bat.find(k); });
+		cout << threads[i] << " threads (Mlookups/s): mutex+find " << tMutex << "  peek " << tNever
+			<< "  random 1/64 " << tRnd << "  batched 256 " << tBat << endl;
+	}
+}
+
+// mixed 80% find / 10% insert / 10% delete: one mutex around SplayTree vs 16 shards by hash (with
+// std::allocator and with PoolAlloc, an arena per shard) and by range
+static void runSharded(int n) {
+	vector<int> ops(4 * n);	// key * 8 + op
+	mt19937 rng(2468);
+	for (size_t i = 0; i < ops.size(); i++)
+		ops[i] = (int)(rng() % (2 * n)) * 8 + (int)(rng() % 10 < 8 ? 0 : rng() % 2 + 1);
+	vector<int> bounds;
+	for (int i = 1; i < 16; i++)
+		bounds.push_back(2 * n / 16 * i);
+	int threads[] = { 1, 4, 16, 32 };
+	for (int i = 0; i < 4; i++) {
+		SplayTree<int, NULLT, DefCmp<int> > ST;
+		mutex m;
+		ShardedSplayTree<int, NULLT, DefCmp<int> > byHash(16), byRange(bounds);
+		ShardedSplayTree<int, NULLT, DefCmp<int>, PoolAlloc<int> > byPool(16);
+		for (int k = 0; k < 2 * n; k += 2) {
+			ST.Insert(k);
+			byHash.Insert(k);
+			byRange.Insert(k);
+			byPool.Insert(k);
+		}
+		double tMutex = runThreads(threads[i], 4 * n, ops, [&](int x) {
+			lock_guard<mutex> lock(m);
+			int op = x % 8, k = x / 8;
+			return op == 0 ? ST.find(k) != NULL : op == 1 ? ST.Insert(k) : ST.Delete(k);
+		});
+		double tHash = runThreads(threads[i], 4 * n, ops, [&](int x) {
+			int op = x % 8, k = x / 8;
+			return op == 0 ? byHash.find(k) : op == 1 ? byHash.Insert(k) : byHash.Delete(k);
+		});
+		double tRange = runThreads(threads[i], 4 * n, ops, [&](int x) {
+			int op = x % 8, k = x / 8;
+			return op == 0 ? byRange.find(k) : op == 1 ? byRange.Insert(k) : byRange.Delete(k);
+		});
+		double tPool = runThreads(threads[i], 4 * n, ops, [&](int x) {
+			int op = x % 8, k = x / 8;
+			return op == 0 ? byPool.find(k) : op == 1 ? byPool.Insert(k) : byPool.Delete(k);
+		});
+		cout << threads[i] << " threads (Mops/s): mutex " << tMutex << "  16 hash shards " << tHash
+			<< "  16 range shards " << tRange << "  16 hash shards, PoolAlloc " << tPool << endl;
+	}
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? atoi(argv[1]) : 20000;
+	mt19937 rng(12345);
+	vector<int> sorted(n), shuffled(n);
+	for (int i = 0; i < n; i++)
+		sorted[i] = shuffled[i] = i;
+	shuffle(shuffled.begin(), shuffled.end(), rng);
+
+	cout << "== splay: sorted and random key streams ==" << endl;
+	runSplay<SplayTree<int> >("sorted", sorted, sorted);
+	runSplay<SplayTree<int> >("random", shuffled, shuffled);
+
+	cout << "== compare policy: PtrCmp (function pointer) vs DefCmp (inlined) ==" << endl;
+	runSplay<SplayTree<int, NULLT, PtrCmp<int> > >("PtrCmp", shuffled, shuffled);
+	runSplay<SplayTree<int, NULLT, DefCmp<int> > >("DefCmp", shuffled, shuffled);
+	runSplay<SplayTree<int, NULLT, LessCmp<int> > >("LessCmp", shuffled, shuffled);
+
+	cout << "== insert: random, sorted and Zipfian streams ==" << endl;
+	runInsert<SplayTree<int, NULLT, DefCmp<int> > >("random", shuffled);
+	runInsert<SplayTree<int, NULLT, DefCmp<int> > >("sorted", sorted);
+	runInsert<SplayTree<int, NULLT, DefCmp<int> > >("zipf 0.99", zipfKeys(n, n, 0.99, 99));
+
+	cout << "== cold start: " << 10 * n << " keys ==" << endl;
+	runColdStart(10 * n);
+
+	cout << "== range scan: sliding window vs std::map ==" << endl;
+	runRangeScan(n, 16, 1);
+	runRangeScan(n, 256, 64);
+	runRangeScan(n, 16, 997);
+
+	cout << "== split/join: rebalance half of " << n << " keys ==" << endl;
+	runSplit(n);
+
+	cout << "== order statistics: sliding-window p50/p99 ==" << endl;
+	runPercentile(4 * n, min(n / 4, 5000));	// the walk is O(w) per query
+
+	cout << "== augment: range sums ==" << endl;
+	runAggregate(n, 16, n);
+	runAggregate(n, n / 10, 1000);
+
+	cout << "== sequence: positional edits ==" << endl;
+	runSequence(10 * n, n);
+
+	cout << "== splay modes: find on " << n << " keys ==" << endl;
+	runModes("uniform", n, shuffled);
+	runModes("zipf 0.99", n, zipfKeys(4 * n, n, 0.99, 4321));
+	runModes("zipf 1.2", n, zipfKeys(4 * n, n, 1.2, 4321));
+
+	cout << "== batches: " << 10 * n << " keys ==" << endl;
+	runBatch(10 * n, 1000);
+	runBatch(10 * n, 10000);
+
+	cout << "== cache: get-or-put on " << 4 * n << " keys ==" << endl;
+	runCache("zipf 0.99", n / 10, zipfKeys(4 * n, n, 0.99, 2468));
+	runCache("uniform", n / 2, zipfKeys(4 * n, n, 0, 2468));
+
+	cout << "== storage: " << 10 * n << " random keys ==" << endl;
+	{
+		vector<int> keys(10 * n), qry;
+		for (int i = 0; i < 10 * n; i++)
+			keys[i] = (int)rng();
+		qry = keys;
+		shuffle(qry.begin(), qry.end(), rng);
+		runStorage<CompactSplayTree<int, NULLT, DefCmp<int> > >("CompactSplayTree", keys, qry);
+		runStorage<SplayTree<int, NULLT, DefCmp<int> > >("SplayTree", keys, qry);
+	}
+
+	cout << "== concurrent: Zipf lookups on " << thread::hardware_concurrency() << " cores ==" << endl;
+	runConcurrent(n);
+
+	cout << "== sharded: mixed find/insert/delete ==" << endl;
+	runSharded(n);
+
+	cout << "== allocator: insert/delete churn ==" << endl;
+	runChurn<SplayTree<int, NULLT, DefCmp<int> > >("std::allocator", n, 4 * n);
+	runChurn<SplayTree<int, NULLT, DefCmp<int>, PoolAlloc<int> > >("PoolAlloc", n, 4 * n);
+	runChurn<SplayTree<int, NULLT, DefCmp<int>, PoolAlloc<int> > >("PoolAlloc", n, 100 * n);
+
+	cout << "== extract: move nodes between trees ==" << endl;
+	{
+		SplayTree<int, NULLT, DefCmp<int> > a, b;
+		runExtract("std::allocator", a, b, n, 4);
+		PoolAlloc<int> arena;	// shared, so nodes move without a copy
+		SplayTree<int, NULLT, DefCmp<int>, PoolAlloc<int> > pa(DefCmp<int>(), arena), pb(DefCmp<int>(), arena);
+		runExtract("PoolAlloc, shared", pa, pb, n, 4);
+		SplayTree<int, NULLT, DefCmp<int>, PoolAlloc<int> > qa, qb;	// an arena each: every move is a copy
+		runExtract("PoolAlloc, separate", qa, qb, n, 4);
+	}
+	return 0;
+}
@@ -0,0 +1,381 @@
+// Benchmark suite: SplayTree against std::map, std::set and std::unordered_map.
+// Build: g++ -O2 -std=c++17 -DSPLAY_STATS suite.cpp -o suite
+// Run:   ./suite [n] [--csv | --json] > results
+// Every case runs in a forked child (Linux/POSIX), so that its peak RSS is its own.
+// Compares are counted by the compare policies; rotations need SPLAY_STATS.
+#include "SplayTree.h"
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+static unsigned long long nCompare = 0;	// compares made by the container under test
+
+template<class K>
+class CountCmp {	// the compare policy of SplayTree
+public :
+	int operator()(const K &a, const K &b) const {
+		nCompare++;
+		return dCmp(a, b);
+	}
+};
+
+template<class K>
+class CountLess {	// the same for std::map and std::set
+public :
+	bool operator()(const K &a, const K &b) const {
+		nCompare++;
+		return a < b;
+	}
+};
+
+template<class K>
+class CountEq {	// and for std::unordered_map
+public :
+	bool operator()(const K &a, const K &b) const {
+		nCompare++;
+		return a == b;
+	}
+};
+
+// the i-th smallest key of each type
+template<class K> struct KeyType;
+template<> struct KeyType<int> {
+	static const char *name() { return "int"; }
+	static int make(int i) { return i; }
+};
+template<> struct KeyType<long long> {
+	static const char *name() { return "int64"; }
+	static long long make(int i) { return (1LL << 40) + (long long)i * 1000003; }
+};
+template<> struct KeyType<string> {
+	static const char *name() { return "string"; }
+	static string make(int i) {	// a long shared prefix, as in real keys
+		char buf[32];
+		snprintf(buf, sizeof(buf), "user:%012d", i);
+		return buf;
+	}
+};
+
+// the containers, behind one interface
+template<class K>
+class SplayBox {
+	SplayTree<K, int, CountCmp<K> > ST;
+public :
+	static const char *name() { return "SplayTree"; }
+	static bool ordered() { return true; }
+	void insert(const K &k) { ST.try_emplace(k, 0); }
+	bool find(const K &k) { return ST.find(k) != NULL; }
+	void erase(const K &k) { ST.Delete(k); }
+	int scan(const K &k, int w) {
+		int n = 0;
+		for (typename SplayTree<K, int, CountCmp<K> >::iterator it = ST.lower_bound(k); it != ST.end() && n < w; ++it)
+			n++;
+		return n;
+	}
+	long long rotations() const {
+#ifdef SPLAY_STATS
+		return (long long)ST.getRotCount();
+#else
+		return -1;
+#endif
+	}
+	void resetRotations() {
+#ifdef SPLAY_STATS
+		ST.resetRotCount();
+#endif
+	}
+};
+
+template<class K>
+class MapBox {
+	map<K, int, CountLess<K> > M;
+public :
+	static const char *name() { return "std::map"; }
+	static bool ordered() { return true; }
+	void insert(const K &k) { M.emplace(k, 0); }
+	bool find(const K &k) { return M.find(k) != M.end(); }
+	void erase(const K &k) { M.erase(k); }
+	int scan(const K &k, int w) {
+		int n = 0;
+		for (typename map<K, int, CountLess<K> >::iterator it = M.lower_bound(k); it != M.end() && n < w; ++it)
+			n++;
+		return n;
+	}
+	long long rotations() const { return -1; }
+	void resetRotations() {}
+};
+
+template<class K>
+class SetBox {
+	set<K, CountLess<K> > S;
+public :
+	static const char *name() { return "std::set"; }
+	static bool ordered() { return true; }
+	void insert(const K &k) { S.insert(k); }
+	bool find(const K &k) { return S.find(k) != S.end(); }
+	void erase(const K &k) { S.erase(k); }
+	int scan(const K &k, int w) {
+		int n = 0;
+		for (typename set<K, CountLess<K> >::iterator it = S.lower_bound(k); it != S.end() && n < w; ++it)
+			n++;
+		return n;
+	}
+	long long rotations() const { return -1; }
+	void resetRotations() {}
+};
+
+template<class K>
+class HashBox {
+	unordered_map<K, int, hash<K>, CountEq<K> > H;
+public :
+	static const char *name() { return "std::unordered_map"; }
+	static bool ordered() { return false; }
+	void insert(const K &k) { H.emplace(k, 0); }
+	bool find(const K &k) { return H.find(k) != H.end(); }
+	void erase(const K &k) { H.erase(k); }
+	int scan(const K &, int) { return 0; }
+	long long rotations() const { return -1; }
+	void resetRotations() {}
+};
+
+// the access patterns, as positions in [0, n)
+enum Pattern { Uniform, Sequential, Zipf08, Zipf099, Zipf12, Shift, Adversarial };
+static const char *patternName[] = { "uniform", "sequential", "zipf0.8", "zipf0.99", "zipf1.2", "shift", "adversarial" };
+
+// Zipf ranks over n positions; the ranks are shuffled so that hot keys are spread out
+static vector<int> zipf(int n, int m, double skew, mt19937 &rng) {
+	vector<double> cdf(n);
+	double sum = 0;
+	for (int i = 0; i < n; i++) {
+		sum += 1.0 / pow((double)(i + 1), skew);
+		cdf[i] = sum;
+	}
+	vector<int> perm(n), pos(m);
+	for (int i = 0; i < n; i++)
+		perm[i] = i;
+	shuffle(perm.begin(), perm.end(), rng);
+	uniform_real_distribution<double> u(0, sum);
+	for (int i = 0; i < m; i++)
+		pos[i] = perm[min((int)(lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()), n - 1)];
+	return pos;
+}
+
+static vector<int> positions(Pattern p, int n, int m, mt19937 &rng) {
+	vector<int> pos(m);
+	int hot = max(n / 100, 1), bits = 0;
+	switch (p) {
+	case Uniform:
+		for (int i = 0; i < m; i++)
+			pos[i] = (int)(rng() % n);
+		break;
+	case Sequential:
+		for (int i = 0; i < m; i++)
+			pos[i] = i % n;
+		break;
+	case Zipf08:
+		return zipf(n, m, 0.8, rng);
+	case Zipf099:
+		return zipf(n, m, 0.99, rng);
+	case Zipf12:
+		return zipf(n, m, 1.2, rng);
+	case Shift:	// 90% of the accesses go to a window of 1% of the keys, which moves ten times
+		for (int i = 0; i < m; i++) {
+			int base = (int)((long long)(i / max(m / 10, 1)) * (n / 10) % n);
+			pos[i] = rng() % 10 < 9 ? (base + (int)(rng() % hot)) % n : (int)(rng() % n);
+		}
+		break;
+	case Adversarial:	// bit-reversal order, which no splay tree can serve in less than O(log n)
+		while ((1 << bits) < n)
+			bits++;
+		for (int i = 0, j = 0; i < m; j++) {
+			int r = 0;
+			for (int b = 0; b < bits; b++)
+				if (j & (1 << b))
+					r |= 1 << (bits - 1 - b);
+			if (r < n)
+				pos[i++] = r;
+		}
+		break;
+	}
+	return pos;
+}
+
+// one result row
+struct Result {
+	const char *container, *keyType, *workload, *pattern;
+	long long ops;
+	double opsPerSec, p50, p99, cmpPerOp, rotPerOp;
+	long peakKB;
+};
+
+enum Format { Table, Csv, Json };
+
+static void printRow(const Result &r, Format f, bool first) {
+	char rot[32];
+	if (r.rotPerOp < 0)
+		snprintf(rot, sizeof(rot), f == Json ? "null" : "-");
+	else
+		snprintf(rot, sizeof(rot), "%.2f", r.rotPerOp);
+	if (f == Csv)
+		printf("%s,%s,%s,%s,%lld,%.0f,%.0f,%.0f,%.2f,%s,%ld\n", r.container, r.keyType, r.workload, r.pattern,
+			r.ops, r.opsPerSec, r.p50, r.p99, r.cmpPerOp, r.rotPerOp < 0 ? "" : rot, r.peakKB);
+	else if (f == Json)
+		printf("%s{\"container\":\"%s\",\"key\":\"%s\",\"workload\":\"%s\",\"pattern\":\"%s\",\"ops\":%lld,"
+			"\"ops_per_sec\":%.0f,\"p50_ns\":%.0f,\"p99_ns\":%.0f,\"cmp_per_op\":%.2f,\"rot_per_op\":%s,"
+			"\"peak_rss_kb\":%ld}\n", first ? "" : ",", r.container, r.keyType, r.workload, r.pattern, r.ops,
+			r.opsPerSec, r.p50, r.p99, r.cmpPerOp, rot, r.peakKB);
+	else
+		printf("%-18s %-6s %-6s %-11s %11.0f ops/s  p50 %6.0f ns  p99 %7.0f ns  %6.2f cmp/op  %5s rot/op  %8ld KB\n",
+			r.container, r.keyType, r.workload, r.pattern, r.opsPerSec, r.p50, r.p99, r.cmpPerOp, rot, r.peakKB);
+}
+
+// runs "op" m times; every 8th call is timed on its own for the latencies
+template<class Op>
+static void measure(int m, Op op, Result &r) {
+	vector<double> lat;
+	lat.reserve(m / 8 + 1);
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now(), t;
+	for (int i = 0; i < m; i++) {
+		if (i % 8 != 0) {
+			op(i);
+			continue;
+		}
+		t = chrono::steady_clock::now();
+		op(i);
+		lat.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - t).count());
+	}
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+	r.ops = m;
+	r.opsPerSec = m / ms * 1000;
+	nth_element(lat.begin(), lat.begin() + lat.size() / 2, lat.end());
+	r.p50 = lat[lat.size() / 2];
+	nth_element(lat.begin(), lat.begin() + lat.size() * 99 / 100, lat.end());
+	r.p99 = lat[lat.size() * 99 / 100];
+}
+
+// one case: "workload" is insert, find, delete or range
+template<class Box, class K>
+static Result runCase(const char *workload, Pattern p, int n) {
+	mt19937 rng(2024);
+	Result r = { Box::name(), KeyType<K>::name(), workload, patternName[p], 0, 0, 0, 0, 0, -1, 0 };
+	vector<K> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = KeyType<K>::make(i);
+	vector<int> load(n);
+	for (int i = 0; i < n; i++)
+		load[i] = i;
+	shuffle(load.begin(), load.end(), rng);
+	Box box;
+	long long sink = 0;
+	if (strcmp(workload, "insert") == 0) {
+		vector<int> pos = p == Uniform ? load : positions(p, n, n, rng);
+		nCompare = 0;
+		measure(n, [&](int i) { box.insert(keys[pos[i]]); }, r);
+	}
+	else {
+		for (int i = 0; i < n; i++)
+			box.insert(keys[load[i]]);
+		box.resetRotations();
+		if (strcmp(workload, "find") == 0) {
+			vector<int> pos = positions(p, n, 2 * n, rng);
+			nCompare = 0;
+			measure(2 * n, [&](int i) { sink += box.find(keys[pos[i]]); }, r);
+		}
+		else if (strcmp(workload, "delete") == 0) {
+			shuffle(load.begin(), load.end(), rng);	// not in the order of the inserts
+			vector<int> pos = p == Uniform ? load : positions(Sequential, n, n, rng);
+			nCompare = 0;
+			measure(n, [&](int i) { box.erase(keys[pos[i]]); }, r);
+		}
+		else {	// range: a lower_bound and a scan of 16 keys
+			vector<int> pos = positions(p, n, n / 4, rng);
+			nCompare = 0;
+			measure(n / 4, [&](int i) { sink += box.scan(keys[pos[i]], 16); }, r);
+		}
+	}
+	r.cmpPerOp = (double)nCompare / r.ops;
+	if (box.rotations() >= 0)
+		r.rotPerOp = (double)box.rotations() / r.ops;
+	if (sink == -1)
+		printf("\n");	// keeps "sink" alive
+	return r;
+}
+
+// runs a case in a child process and prints its row; returns false if the child failed
+template<class Box, class K>
+static bool fork1(const char *workload, Pattern p, int n, Format f, bool first) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid == 0) {
+		Result r = runCase<Box, K>(workload, p, n);
+		struct rusage ru;
+		getrusage(RUSAGE_SELF, &ru);
+		r.peakKB = ru.ru_maxrss;	// KB on Linux
+		printRow(r, f, first);
+		fflush(stdout);
+		_exit(0);
+	}
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// every workload and pattern for one container and key type
+template<template<class> class Box, class K>
+static int runAll(int n, Format f, bool &first) {
+	int failed = 0;
+	Pattern inserts[] = { Uniform, Sequential };
+	Pattern finds[] = { Uniform, Sequential, Zipf08, Zipf099, Zipf12, Shift, Adversarial };
+	Pattern ranges[] = { Uniform, Zipf099 };
+	for (int i = 0; i < 2; i++, first = false)
+		failed += !fork1<Box<K>, K>("insert", inserts[i], n, f, first);
+	for (int i = 0; i < 7; i++, first = false)
+		failed += !fork1<Box<K>, K>("find", finds[i], n, f, first);
+	for (int i = 0; i < 2; i++, first = false)
+		failed += !fork1<Box<K>, K>("delete", inserts[i], n, f, first);
+	if (Box<K>::ordered())
+		for (int i = 0; i < 2; i++, first = false)
+			failed += !fork1<Box<K>, K>("range", ranges[i], n, f, first);
+	return failed;
+}
+
+template<class K>
+static int runKey(int n, Format f, bool &first) {
+	return runAll<SplayBox, K>(n, f, first) + runAll<MapBox, K>(n, f, first)
+		+ runAll<SetBox, K>(n, f, first) + runAll<HashBox, K>(n, f, first);
+}
+
+int main(int argc, char **argv) {
+	int n = 100000, failed = 0;
+	Format f = Table;
+	bool first = true;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--csv") == 0)
+			f = Csv;
+		else if (strcmp(argv[i], "--json") == 0)
+			f = Json;
+		else
+			n = max(atoi(argv[i]), 16);
+	}
+	if (f == Csv)
+		printf("container,key,workload,pattern,ops,ops_per_sec,p50_ns,p99_ns,cmp_per_op,rot_per_op,peak_rss_kb\n");
+	else if (f == Json)
+		printf("[\n");
+	failed += runKey<int>(n, f, first);
+	failed += runKey<long long>(n, f, first);
+	failed += runKey<string>(n, f, first);
+	if (f == Json)
+		printf("]\n");
+	return failed == 0 ? 0 : 1;
+}
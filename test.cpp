@@ -1,5 +1,12 @@
 #include "SplayTree.h"
+#include "SplaySequence.h"
+#include "ConcurrentSplayTree.h"
+#include "ShardedSplayTree.h"
+#include "SplayCache.h"
+#include "CompactSplayTree.h"
 #include <string>
+#include <vector>
+#include <thread>
 using namespace std;
 
 class A {
@@ -32,6 +39,15 @@ int cmp(const A &a, const A &b) {
 	return 0;
 }
 
+// sums the records of a subtree
+class SumRcd {
+public :
+	typedef int value_type;
+	static int identity() { return 0; }
+	static int lift(const int &, const int &rcd) { return rcd; }
+	static int combine(const int &a, const int &b) { return a + b; }
+};
+
 int main() {
 	{
 		SplayTree<int> ST1;
@@ -97,5 +113,215 @@ int main() {
 		cout << "--------------------------------------" << endl;
 		ST.print();
 	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<string, string> ST;
+		ST.emplace(3, 'c');	// string(3, 'c')
+		ST.try_emplace(string("b"), 2, 'x');
+		cout << ST.try_emplace(string("b"), "unused").second << " " << *ST.find("b") << endl;
+		vector<SplayTree<string, string> > V;
+		V.push_back(std::move(ST));
+		SplayTree<string, string> other;
+		other.Insert(string("a"));
+		swap(V[0], other);
+		cout << V[0].rootID() << " " << (other.find("ccc") != NULL) << " " << (ST.find("b") != NULL) << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 1; i < 8; i++)
+			ST.Insert(i * 3 % 8);
+		for (SplayTree<int>::iterator it = ST.begin(); it != ST.end(); ++it)
+			cout << it->getID() << ' ';
+		for (SplayTree<int>::reverse_iterator it = ST.rbegin(); it != ST.rend(); ++it)
+			cout << it->getID() << ' ';
+		cout << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 1; i < 8; i++)
+			ST.Insert(i * 2);	// 2 4 ... 14
+		cout << ST.lower_bound(5)->getID() << " " << ST.upper_bound(6)->getID() << " "
+			<< (ST.upper_bound(14) == ST.end()) << " " << ST.countInRange(4, 11) << endl;
+		ST.forEachInRange(3, 9, [](const Node<int> &nd) { cout << nd.getID() << ' '; });
+		cout << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST, odd;
+		for (int i = 1; i < 8; i++) {
+			ST.Insert(i);
+			odd.Insert(2 * i + 1);
+		}
+		SplayTree<int> hi = ST.split(5);	// ST: 1..4  hi: 5..7
+		cout << ST.join(odd) << " " << hi.join(ST) << " ";	// overlaps: both fail
+		hi.merge(ST);
+		hi.merge(odd);
+		for (SplayTree<int>::iterator it = hi.begin(); it != hi.end(); ++it)
+			cout << it->getID() << ' ';
+		cout << (ST.begin() == ST.end()) << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 1; i < 8; i++)
+			ST.Insert(i * 10);
+		ST.Delete(40);
+		cout << ST.getSize() << " " << ST.rank(35) << " " << ST.rank(50) << " "
+			<< ST.select(3)->getID() << " " << (ST.select(6) == ST.end()) << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int, int> ST;
+		vector<pair<int, int> > items = { { 5, 50 }, { 1, 10 }, { 5, 99 }, { 3, 30 } };
+		vector<int*> out;
+		cout << ST.insertBatch(items) << " ";	// the first 5 is kept
+		cout << ST.findBatch(vector<int>{ 3, 4, 5, 1 }, out) << " " << *out[0] << " " << (out[1] == NULL) << " "
+			<< *out[2] << " " << ST.deleteBatch(vector<int>{ 1, 2, 1 }) << " " << ST.getSize() << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 1; i < 8; i++)
+			ST.Insert(i);	// 7 at the root, then a left chain down to 1
+		ST.setSplayMode(SplayDepth, 3);
+		ST.find(5);	// depth 2: left where it is
+		cout << ST.rootID() << " ";
+		ST.find(1);	// depth 6: splayed to the root
+		cout << ST.rootID() << " ";
+		ST.setSplayMode(SplaySemi);
+		ST.find(7);
+		cout << ST.getHeight() << " " << (ST.find(4) != NULL) << " " << ST.setSplayMode(SplayRandom, 2) << " "
+			<< (ST.split(4).getSplayMode() == SplaySemi) << endl;	// the right part keeps the mode
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int, int, DefCmp<int>, allocator<int>, SumRcd> ST;
+		for (int i = 1; i < 8; i++)
+			ST.try_emplace(i, i * i);
+		cout << ST.aggregate() << " " << ST.aggregate(2, 5) << " ";	// 140 29
+		*ST.find(3) = 0;
+		ST.refresh();
+		cout << ST.aggregate(2, 5) << " ";	// 20
+		ST.setSplayMode(SplayDepth, 100);	// ignored: an augmented find always splays
+		*ST.find(7) = 0;
+		ST.refresh();
+		cout << ST.aggregate() << endl;	// 82
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int, int, DefCmp<int>, allocator<int>, SumRcd> ST;
+		cout << ST.insert(1, 10).second << ST.insert(1, 99).second << " ";	// the second keeps 10
+		cout << ST.insert_or_assign(1, 5).second << ST.insert_or_assign(2, 7).second << " ";
+		ST.upsert(2, [](int &r) { r *= 3; });
+		pair<int*, bool> r = ST.upsert(3, [](int &r) { r += 4; });
+		cout << *r.first << r.second << " " << *ST.findOrInsert(1).first << " " << ST.aggregate() << endl;	// 5 + 21 + 4
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int, int, DefCmp<int>, allocator<int>, SumRcd> ST, other;
+		for (int i = 1; i < 8; i++)
+			ST.try_emplace(i, i * 10);
+		SplayTree<int, int, DefCmp<int>, allocator<int>, SumRcd>::node_type nh = ST.extract(4);
+		cout << ST.getSize() << " " << ST.aggregate() << " " << nh.key() << " " << ST.extract(4).empty() << " ";
+		nh.mapped() = 1;
+		cout << other.insert(std::move(nh)).second << " " << nh.empty() << " " << other.aggregate() << " ";
+		other.try_emplace(5, 0);
+		nh = ST.extract(5);
+		cout << other.insert(std::move(nh)).second << " " << nh.key() << endl;	// 5 is there: the handle keeps it
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		string s = "abcdefg";
+		SplaySequence<char> SQ(s.begin(), s.end());
+		SQ.reverse(1, 6);	// afedcbg
+		SQ.eraseRange(2, 4);	// afcbg
+		SQ.insertAt(0, 'x');	// xafcbg
+		SQ.addRange(4, 6, 1);	// xafcch
+		SQ.forEach([](const char &c) { cout << c; });
+		cout << " " << SQ.at(2) << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		ConcurrentSplayTree<int, int> CT(AdaptBatched, 16);
+		for (int i = 0; i < 100; i++)
+			CT.try_emplace(i, i * i);
+		vector<thread> readers;
+		for (int t = 0; t < 4; t++)
+			readers.push_back(thread([&CT, t]() {
+				for (int i = 0; i < 1000; i++)
+					CT.find((i * 7 + t) % 100);
+			}));
+		for (size_t t = 0; t < readers.size(); t++)
+			readers[t].join();
+		CT.flush();
+		int rcd = 0;
+		cout << CT.getSize() << " " << CT.peek(9, &rcd) << " " << rcd << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		ShardedSplayTree<int> byHash(4), byRange(vector<int>{10, 20});
+		for (int i = 0; i < 30; i += 3) {
+			byHash.Insert(i);
+			byRange.Insert(i);
+		}
+		byHash.Delete(9);
+		byHash.forEach([](const Node<int> &nd) { cout << nd.getID() << ' '; });
+		cout << byHash.getSize() << " " << byRange.find(12) << " ";
+		byRange.forEachInRange(8, 22, [](const Node<int> &nd) { cout << nd.getID() << ' '; });
+		cout << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		SplayCache<int, int> LRU(3), bySize(0, 10);
+		for (int i = 1; i <= 3; i++)
+			LRU.put(i, i * 10);
+		LRU.get(1);
+		LRU.put(4, 40);	// 2 is the least recently used
+		cout << (LRU.get(2) == NULL) << " " << *LRU.get(1) << " " << LRU.getHitCount() << " "
+			<< LRU.getMissCount() << " " << LRU.getEvictCount() << " ";
+		bySize.put(1, 1, 6);
+		bySize.put(2, 2, 6);	// 12 bytes: 1 goes
+		cout << bySize.getSize() << " " << bySize.getBytes() << " " << bySize.put(3, 3, 11) << endl;
+	}
+	{
+		cout << "--------------------------------------" << endl;
+		CompactSplayTree<int, int> CT;
+		for (int i = 1; i < 8; i++)
+			CT.try_emplace(i * 3 % 8, i);
+		CT.Delete(2);
+		CT.Delete(5);
+		CT.try_emplace(9, 90);	// takes the slot 5 left
+		CT.forEach([](const int &id, int &rcd) { cout << id << ':' << rcd << ' '; });
+		cout << CT.getSize() << " " << *CT.find(9) << " " << (CT.peek(5) == NULL) << endl;
+	}
+	{
+		// 1M sequential inserts leave a chain; copying and destroying it must not recurse
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 0; i < 1000000; i++)
+			ST.Insert(i);
+		SplayTree<int> CP(ST);
+		cout << "chain height: " << ST.getHeight() << " copy: " << CP.getHeight() << endl;
+	}
+#ifdef SPLAY_STATS
+	{
+		cout << "--------------------------------------" << endl;
+		SplayTree<int> ST;
+		for (int i = 1; i < 8; i++)
+			ST.Insert(i);
+		ST.resetCmpCount();
+		ST.resetRotCount();
+		ST.find(1);	// 7 nodes on the path, one compare each
+		cout << "compares: " << ST.getCmpCount() << " rotations: " << ST.getRotCount() << endl;
+		ST.resetStats();
+		ST.Delete(4);
+		ST.find(4);
+		SplayStats stats = ST.getStats();
+		cout << "finds: " << stats.ops[SplayStats::OpFind] << " frees: " << stats.frees << " zig-zigs: "
+			<< stats.cases[3] << " max depth: " << stats.maxDepth << endl;
+	}
+#endif
 	system("pause");
 }